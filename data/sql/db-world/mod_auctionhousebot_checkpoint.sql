@@ -0,0 +1,22 @@
+--
+-- State of the houses and of the bots at the last shutdown or reload, to resume without recounting
+--
+
+CREATE TABLE IF NOT EXISTS `mod_auctionhousebot_checkpoint` (
+  `auctionhouse` int(11) NOT NULL DEFAULT '0' COMMENT 'mapID of the auctionhouse.',
+  `time` int(10) unsigned NOT NULL DEFAULT '0' COMMENT 'When the checkpoint was taken.',
+  `epoch` int(10) unsigned NOT NULL DEFAULT '0' COMMENT 'Full recounts of the auctionhouse so far.',
+  `auctions` int(10) unsigned NOT NULL DEFAULT '0' COMMENT 'Auctions listed in the auctionhouse.',
+  `lastid` int(10) unsigned NOT NULL DEFAULT '0' COMMENT 'Highest auction id listed in the auctionhouse.',
+  `onlybots` tinyint(1) NOT NULL DEFAULT '0' COMMENT 'ConsiderOnlyBotAuctions when the counters were taken.',
+  `counts` varchar(255) NOT NULL DEFAULT '' COMMENT 'Comma separated auctions per category.',
+  PRIMARY KEY (`auctionhouse`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8;
+
+CREATE TABLE IF NOT EXISTS `mod_auctionhousebot_checkpoint_bots` (
+  `auctionhouse` int(11) NOT NULL DEFAULT '0' COMMENT 'mapID of the auctionhouse.',
+  `bot` int(10) unsigned NOT NULL DEFAULT '0' COMMENT 'Character of the bot.',
+  `lastrun` int(10) unsigned NOT NULL DEFAULT '0' COMMENT 'Last buyer run of the bot in the auctionhouse.',
+  `auctions` mediumtext NOT NULL COMMENT 'Comma separated ids of the auctions owned by the bot.',
+  PRIMARY KEY (`auctionhouse`, `bot`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8;
@@ -0,0 +1,14 @@
+--
+-- Market prices learned by the bots, kept across restarts
+--
+
+CREATE TABLE IF NOT EXISTS `mod_auctionhousebot_market` (
+  `auctionhouse` int(11) NOT NULL DEFAULT '0' COMMENT 'mapID of the auctionhouse.',
+  `item` mediumint(8) unsigned NOT NULL DEFAULT '0' COMMENT 'Item template.',
+  `random` int(11) NOT NULL DEFAULT '0' COMMENT 'Random property (negative for suffixes), 0 for the whole template.',
+  `samples` int(10) unsigned NOT NULL DEFAULT '0' COMMENT 'Number of auctions considered since the last market reset.',
+  `total` bigint(20) unsigned NOT NULL DEFAULT '0' COMMENT 'Sum of the per unit prices of the considered auctions.',
+  `price` bigint(20) unsigned NOT NULL DEFAULT '0' COMMENT 'Current per unit market price.',
+  `sketch` varbinary(256) NOT NULL DEFAULT '' COMMENT 'Quantile sketch of the per unit prices.',
+  PRIMARY KEY (`auctionhouse`, `item`, `random`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8;
@@ -17,16 +17,23 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#include <iterator>
+
 #include "ObjectMgr.h"
 #include "AuctionHouseMgr.h"
 #include "Config.h"
-#include "Player.h"
-#include "WorldSession.h"
+#include "Item.h"
+#include "World.h"
 #include "GameTime.h"
 #include "DatabaseEnv.h"
+#include "StringFormat.h"
 
 #include "AuctionHouseBot.h"
 #include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotItem.h"
+#include "AuctionHouseBotJob.h"
+#include "AuctionHouseBotLoad.h"
+#include "AuctionHouseBotSynthetic.h"
 
 using namespace std;
 
@@ -34,6 +41,7 @@ AuctionHouseBot::AuctionHouseBot(uint32 account, uint32 id)
 {
     _account        = account;
     _id             = id;
+    _guid           = ObjectGuid::Create<HighGuid::Player>(id);
 
     _lastrun_a_sec  = time(NULL);
     _lastrun_h_sec  = time(NULL);
@@ -49,29 +57,16 @@ AuctionHouseBot::~AuctionHouseBot()
     // Nothing
 }
 
-uint32 AuctionHouseBot::getElement(std::set<uint32> set, int index, uint32 botId, uint32 maxDup, AuctionHouseObject* auctionHouse)
+uint32 AuctionHouseBot::getElement(std::set<uint32> const& set, int index, uint32 maxDup, std::unordered_map<uint32, uint32> const& listed)
 {
-    std::set<uint32>::iterator it = set.begin();
+    std::set<uint32>::const_iterator it = set.begin();
     std::advance(it, index);
 
     if (maxDup > 0)
     {
-        uint32 noStacks = 0;
-
-        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
-        {
-            AuctionEntry* Aentry = itr->second;
-
-            if (Aentry->owner.GetCounter() == botId)
-            {
-                if (*it == Aentry->item_template)
-                {
-                    noStacks++;
-                }
-            }
-        }
+        std::unordered_map<uint32, uint32>::const_iterator noStacks = listed.find(*it);
 
-        if (noStacks >= maxDup)
+        if (noStacks != listed.end() && noStacks->second >= maxDup)
         {
             return 0;
         }
@@ -97,17 +92,17 @@ uint32 AuctionHouseBot::getStackCount(AHBConfig* config, uint32 max)
 
         if (max % 5 == 0) // 5, 10, 15, 20
         {
-            ret = urand(1, 4) * 5;
+            ret = random(1, 4) * 5;
         }
 
         if (max % 4 == 0) // 4, 8, 12, 16
         {
-            ret = urand(1, 4) * 4;
+            ret = random(1, 4) * 4;
         }
 
         if (max % 3 == 0) // 3, 6, 9, 18
         {
-            ret = urand(1, 3) * 3;
+            ret = random(1, 3) * 3;
         }
 
         if (ret > max)
@@ -122,7 +117,47 @@ uint32 AuctionHouseBot::getStackCount(AHBConfig* config, uint32 max)
     // Totally random
     // 
 
-    return urand(1, max);
+    return random(1, max);
+}
+
+uint32 AuctionHouseBot::getBundleSize(AHBConfig* config, uint32 max)
+{
+    if (max <= 1 || config->BundleWeights.empty())
+    {
+        return 1;
+    }
+
+    //
+    // The n-th weight is the chance of listing n stacks together
+    //
+
+    uint32 total = 0;
+
+    for (uint32 weight : config->BundleWeights)
+    {
+        total += weight;
+    }
+
+    if (total == 0)
+    {
+        return 1;
+    }
+
+    uint32 pick = random(1, total);
+    uint32 size = 1;
+
+    for (uint32 weight : config->BundleWeights)
+    {
+        if (pick <= weight)
+        {
+            break;
+        }
+
+        pick -= weight;
+        size++;
+    }
+
+    return minValue(size, max);
 }
 
 uint32 AuctionHouseBot::getElapsedTime(uint32 timeClass)
@@ -130,13 +165,13 @@ uint32 AuctionHouseBot::getElapsedTime(uint32 timeClass)
     switch (timeClass)
     {
     case 2:
-        return urand(1, 5) * 600;   // SHORT = In the range of one hour
+        return random(1, 5) * 600;   // SHORT = In the range of one hour
 
     case 1:
-        return urand(1, 23) * 3600; // MEDIUM = In the range of one day
+        return random(1, 23) * 3600; // MEDIUM = In the range of one day
 
     default:
-        return urand(1, 3) * 86400; // LONG = More than one day but less than three
+        return random(1, 3) * 86400; // LONG = More than one day but less than three
     }
 }
 
@@ -171,49 +206,228 @@ uint32 AuctionHouseBot::getNofAuctions(AHBConfig* config, AuctionHouseObject* au
     return count;
 }
 
-// =============================================================================
-// This routine performs the bidding operations for the bot
-// =============================================================================
+uint32 AuctionHouseBot::selectItem(AHBConfig* config, std::unordered_map<uint32, uint32> const& listed, uint32 const* counts, uint32 const* maxima, uint32& category)
+{
+    //
+    // Bins in rarity order, the items before the trade goods of the same quality
+    //
+
+    std::set<uint32> const* bins[] =
+    {
+        &config->GreyItemsBin  , &config->GreyTradeGoodsBin  ,
+        &config->WhiteItemsBin , &config->WhiteTradeGoodsBin ,
+        &config->GreenItemsBin , &config->GreenTradeGoodsBin ,
+        &config->BlueItemsBin  , &config->BlueTradeGoodsBin  ,
+        &config->PurpleItemsBin, &config->PurpleTradeGoodsBin,
+        &config->OrangeItemsBin, &config->OrangeTradeGoodsBin,
+        &config->YellowItemsBin, &config->YellowTradeGoodsBin
+    };
+
+    uint32 const categories[] =
+    {
+        AHB_GREY_I  , AHB_GREY_TG  ,
+        AHB_WHITE_I , AHB_WHITE_TG ,
+        AHB_GREEN_I , AHB_GREEN_TG ,
+        AHB_BLUE_I  , AHB_BLUE_TG  ,
+        AHB_PURPLE_I, AHB_PURPLE_TG,
+        AHB_ORANGE_I, AHB_ORANGE_TG,
+        AHB_YELLOW_I, AHB_YELLOW_TG
+    };
+
+    for (uint32 i = 0; i < std::size(bins); ++i)
+    {
+        std::set<uint32> const& bin = *bins[i];
+
+        if (bin.empty() || counts[categories[i]] >= maxima[categories[i]])
+        {
+            continue;
+        }
+
+        uint32 itemID = getElement(bin, random(0, bin.size() - 1), config->DuplicatesCount, listed);
+
+        if (itemID != 0)
+        {
+            category = categories[i];
+            return itemID;
+        }
+    }
+
+    return 0;
+}
+
+void AuctionHouseBot::getPrices(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, uint64& bidPrice, uint64& buyoutPrice)
+{
+    buyoutPrice = config->GetPricing()->GetSellPrice(config, prototype, randomPropertyId, _random);
+
+    buyoutPrice = buyoutPrice * random(config->GetMinPrice(prototype->Quality), config->GetMaxPrice(prototype->Quality));
+    buyoutPrice = buyoutPrice / 100;
 
-void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* session)
+    bidPrice    = buyoutPrice * random(config->GetMinBidPrice(prototype->Quality), config->GetMaxBidPrice(prototype->Quality));
+    bidPrice    = bidPrice / 100;
+}
+
+uint32 AuctionHouseBot::getBidPrice(AHBConfig* config, ItemTemplate const* prototype, uint32 itemCount, int32 randomPropertyId, uint32 currentprice, uint32 outBid, long double& bidMax)
 {
+    bidMax = 0;
+
+    if (prototype->Quality > AHB_MAX_QUALITY)
+    {
+        if (config->DebugOutBuyer)
+        {
+            LOG_ERROR("module", "AHBot [{}]: Quality {} not Supported", _id, prototype->Quality);
+        }
+
+        return 0;
+    }
+
     //
-    // Check if disabled
+    // Prepare portion from maximum bid
     //
 
-    if (!config->AHBBuyer)
+    double bidrate = static_cast<double>(random(1, 100)) / 100;
+
+    //
+    // Check that bid has an acceptable value, as the pricing strategy of the house sees it
+    //
+
+    bidMax = config->GetPricing()->GetBidMax(config, prototype, randomPropertyId, itemCount, currentprice);
+
+    //
+    // Recalculate the bid depending on the type of the item
+    //
+
+    switch (prototype->Class)
     {
-        return;
+        // ammo
+    case 6:
+        bidMax = 0;
+        break;
+    default:
+        break;
+    }
+
+    //
+    // Test the computed bid
+    //
+
+    if (bidMax == 0)
+    {
+        return 0;
     }
 
     //
-    // Retrieve items not owner by the bot and not bought by the bot
+    // Calculate our bid
     //
 
-    QueryResult result = CharacterDatabase.Query("SELECT id FROM auctionhouse WHERE itemowner<>{} AND buyguid<>{}", _id, _id);
+    long double bidvalue = currentprice + ((bidMax - currentprice) * bidrate);
+    uint32      bidprice = static_cast<uint32>(bidvalue);
+
+    //
+    // Check our bid is high enough to be valid. If not, correct it to minimum.
+    //
 
-    if (!result)
+    if ((currentprice + outBid) > bidprice)
     {
-        return;
+        bidprice = currentprice + outBid;
+    }
+
+    return bidprice;
+}
+
+time_t AuctionHouseBot::GetLastRun(AHBConfig* config)
+{
+    if (config == _allianceConfig)
+    {
+        return _lastrun_a_sec;
+    }
+
+    if (config == _hordeConfig)
+    {
+        return _lastrun_h_sec;
+    }
+
+    return _lastrun_n_sec;
+}
+
+void AuctionHouseBot::Seed(uint32 seed)
+{
+    //
+    // Every bot gets its own stream out of the same seed
+    //
+
+    _random.Seed((uint64(seed) << 32) | _id);
+}
+
+uint32 AuctionHouseBot::random(uint32 min, uint32 max)
+{
+    return _random.Range(min, max);
+}
+
+void AuctionHouseBot::record(AHBConfig* config, AHBPhase phase, uint32 us)
+{
+    //
+    // Every sample goes both to the bot and to the auction house statistics
+    //
+
+    _stats.Record(phase, us);
+
+    if (config)
+    {
+        config->Stats.Record(phase, us);
+    }
+}
+
+void AuctionHouseBot::trace(AHBConfig* config, AHBCounter counter, uint32 value)
+{
+    _stats.AddCounter(counter, value);
+
+    if (config)
+    {
+        config->Stats.AddCounter(counter, value);
     }
+}
+
+// =============================================================================
+// This routine performs the bidding operations for the bot
+// =============================================================================
+
+void AuctionHouseBot::Buy(AHBConfig* config)
+{
+    //
+    // Check if disabled
+    //
 
-    if (result->GetRowCount() == 0)
+    if (!config->AHBBuyer)
     {
         return;
     }
 
     //
-    // Fetches content of selected AH to look for possible bids
+    // Retrieve the auctions of the house not owned by the bot and not bought by the bot;
+    // the auction manager holds them all, no need to ask the database
     //
 
+    AHBPhaseClock clock;
+
     AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAHFID());
-    std::set<uint32>    possibleBids;
+    std::vector<uint32> possibleBids;
+
+    if (!auctionHouse)
+    {
+        return;
+    }
 
-    do
+    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
     {
-        uint32 tmpdata = result->Fetch()->Get<uint32>();
-        possibleBids.insert(tmpdata);
-    } while (result->NextRow());
+        AuctionEntry* auction = itr->second;
+
+        if (auction->owner != _guid && auction->bidder != _guid)
+        {
+            possibleBids.push_back(auction->Id);
+        }
+    }
+
+    record(config, AHB_PHASE_BUY_FETCH, clock.Lap());
 
     //
     // If it's not possible to bid stop here
@@ -233,24 +447,24 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
     // Perform the operation for a maximum amount of bids attempts configured
     //
 
-    for (uint32 count = 1; count <= config->GetBidsPerInterval(); ++count)
+    for (uint32 count = 1; count <= config->GetBidsPerInterval() && !possibleBids.empty(); ++count)
     {
+        clock.Lap();
+
         //
         // Choose a random auction from possible auctions
         //
 
-        uint32 randBid = urand(0, possibleBids.size() - 1);
-
-        std::set<uint32>::iterator it = possibleBids.begin();
-        std::advance(it, randBid);
+        uint32 randBid = random(0, possibleBids.size() - 1);
 
-        AuctionEntry* auction = auctionHouse->GetAuction(*it);
+        AuctionEntry* auction = auctionHouse->GetAuction(possibleBids[randBid]);
 
         //
         // Prevent to bid again on the same auction
         //
 
-        possibleBids.erase(randBid);
+        possibleBids[randBid] = possibleBids.back();
+        possibleBids.pop_back();
 
         if (!auction)
         {
@@ -266,6 +480,15 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
             continue;
         }
 
+        //
+        // Nor the synthetic auctions of a load test, which nobody pays for
+        //
+
+        if (gLoadGenerator.IsTestOwner(auction->owner))
+        {
+            continue;
+        }
+
         //
         // Get the item information
         //
@@ -304,126 +527,29 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
         }
 
         //
-        // Prepare portion from maximum bid
-        //
-
-        double      bidrate = static_cast<double>(urand(1, 100)) / 100;
-        long double bidMax  = 0;
-
-        //
-        // Check that bid has an acceptable value and take bid based on vendorprice, stacksize and quality
-        //
-
-        if (config->BuyMethod)
-        {
-            if (prototype->Quality <= AHB_MAX_QUALITY)
-            {
-                if (currentprice < prototype->SellPrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality))
-                {
-                    bidMax = prototype->SellPrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality);
-                }
-            }
-            else
-            {
-                if (config->DebugOutBuyer)
-                {
-                    LOG_ERROR("module", "AHBot [{}]: Quality {} not Supported", _id, prototype->Quality);
-                }
-
-                continue;
-            }
-        }
-        else
-        {
-            if (prototype->Quality <= AHB_MAX_QUALITY)
-            {
-                if (currentprice < prototype->BuyPrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality))
-                {
-                    bidMax = prototype->BuyPrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality);
-                }
-            }
-            else
-            {
-                if (config->DebugOutBuyer)
-                {
-                    LOG_ERROR("module", "AHBot [{}]: Quality {} not Supported", _id, prototype->Quality);
-                }
-
-                continue;
-            }
-        }
-
-        //
-        // Recalculate the bid depending on the type of the item
+        // Evaluate the auction
         //
 
-        switch (prototype->Class)
-        {
-            // ammo
-        case 6:
-            bidMax = 0;
-            break;
-        default:
-            break;
-        }
+        uint32 itemCount        = pItem->GetCount();
+        int32  randomPropertyId = pItem->GetItemRandomPropertyId();
+        uint32 outBid           = auction->GetAuctionOutBid();
+        uint32 buyout           = auction->buyout;
 
-        //
-        // Test the computed bid
-        //
+        long double bidMax   = 0;
+        uint32      bidprice = getBidPrice(config, prototype, itemCount, randomPropertyId, currentprice, outBid, bidMax);
 
-        if (bidMax == 0)
+        if (bidprice == 0)
         {
             continue;
         }
 
         //
-        // Calculate our bid
-        //
-
-        long double bidvalue = currentprice + ((bidMax - currentprice) * bidrate);
-        uint32      bidprice = static_cast<uint32>(bidvalue);
-
-        //
-        // Check our bid is high enough to be valid. If not, correct it to minimum.
+        // Trace the evaluation
         //
 
-        if ((currentprice + auction->GetAuctionOutBid()) > bidprice)
-        {
-            bidprice = currentprice + auction->GetAuctionOutBid();
-        }
-
-        //
-        // Print out debug info
-        //
+        gTracer.Trace(config->DebugOutBuyer, AHB_TRACE_BID_EVALUATION, _id, config->GetAHID(), auction->item_template, itemCount, currentprice, uint64(bidMax), bidprice);
 
-        if (config->DebugOutBuyer)
-        {
-            LOG_INFO("module", "-------------------------------------------------");
-            LOG_INFO("module", "AHBot [{}]: Info for Auction #{}:", _id, auction->Id);
-            LOG_INFO("module", "AHBot [{}]: AuctionHouse: {}"     , _id, auction->GetHouseId());
-            LOG_INFO("module", "AHBot [{}]: Owner: {}"            , _id, auction->owner.ToString());
-            LOG_INFO("module", "AHBot [{}]: Bidder: {}"           , _id, auction->bidder.ToString());
-            LOG_INFO("module", "AHBot [{}]: Starting Bid: {}"     , _id, auction->startbid);
-            LOG_INFO("module", "AHBot [{}]: Current Bid: {}"      , _id, currentprice);
-            LOG_INFO("module", "AHBot [{}]: Buyout: {}"           , _id, auction->buyout);
-            LOG_INFO("module", "AHBot [{}]: Deposit: {}"          , _id, auction->deposit);
-            LOG_INFO("module", "AHBot [{}]: Expire Time: {}"      , _id, uint32(auction->expire_time));
-            LOG_INFO("module", "AHBot [{}]: Bid Rate: {}"         , _id, bidrate);
-            LOG_INFO("module", "AHBot [{}]: Bid Max: {}"          , _id, bidMax);
-            LOG_INFO("module", "AHBot [{}]: Bid Value: {}"        , _id, bidvalue);
-            LOG_INFO("module", "AHBot [{}]: Bid Price: {}"        , _id, bidprice);
-            LOG_INFO("module", "AHBot [{}]: Item GUID: {}"        , _id, auction->item_guid.ToString());
-            LOG_INFO("module", "AHBot [{}]: Item Template: {}"    , _id, auction->item_template);
-            LOG_INFO("module", "AHBot [{}]: Item Info:");
-            LOG_INFO("module", "AHBot [{}]: Item ID: {}"          , _id, prototype->ItemId);
-            LOG_INFO("module", "AHBot [{}]: Buy Price: {}"        , _id, prototype->BuyPrice);
-            LOG_INFO("module", "AHBot [{}]: Sell Price: {}"       , _id, prototype->SellPrice);
-            LOG_INFO("module", "AHBot [{}]: Bonding: {}"          , _id, prototype->Bonding);
-            LOG_INFO("module", "AHBot [{}]: Quality: {}"          , _id, prototype->Quality);
-            LOG_INFO("module", "AHBot [{}]: Item Level: {}"       , _id, prototype->ItemLevel);
-            LOG_INFO("module", "AHBot [{}]: Ammo Type: {}"        , _id, prototype->AmmoType);
-            LOG_INFO("module", "-------------------------------------------------");
-        }
+        record(config, AHB_PHASE_BUY_EVALUATE, clock.Lap());
 
         //
         // Check whether we do normal bid, or buyout
@@ -431,7 +557,7 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
 
         bool bought = false;
 
-        if ((bidprice < auction->buyout) || (auction->buyout == 0))
+        if ((bidprice < buyout) || (buyout == 0))
         {
             //
             // Perform a new bid on the auction
@@ -439,7 +565,7 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
         
             if (auction->bidder)
             {
-                if (auction->bidder != AHBplayer->GetGUID())
+                if (auction->bidder != _guid)
                 {
                     //
                     // Mail to last bidder and return their money
@@ -447,19 +573,34 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
         
                     auto trans = CharacterDatabase.BeginTransaction();
         
-                    sAuctionMgr->SendAuctionOutbiddedMail(auction, bidprice, session->GetPlayer(), trans);
-                    CharacterDatabase.CommitTransaction  (trans);
+                    gOutbidder = _id;
+                    sAuctionMgr->SendAuctionOutbiddedMail(auction, bidprice, nullptr, trans);
+                    gOutbidder = 0;
+
+                    gDbStats.Count(AHB_DB_BUY_OUTBID, AHB_DB_APPEND, uint32(trans->GetSize()));
+
+                    CharacterDatabase.CommitTransaction(trans);
+                    gDbStats.Count(AHB_DB_BUY_OUTBID, AHB_DB_COMMIT);
                 }
             }
         
-            auction->bidder = AHBplayer->GetGUID();
+            auction->bidder = _guid;
             auction->bid    = bidprice;
         
             //
             // Save the auction into database
             //
         
-            CharacterDatabase.Execute("UPDATE auctionhouse SET buyguid = '{}', lastbid = '{}' WHERE id = '{}'", auction->bidder.GetCounter(), auction->bid, auction->Id);
+            CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_AUCTION_BID);
+            stmt->SetData(0, auction->bidder.GetCounter());
+            stmt->SetData(1, auction->bid);
+            stmt->SetData(2, auction->Id);
+
+            CharacterDatabase.Execute(stmt);
+
+            gDbStats.Count(AHB_DB_BUY_BID, AHB_DB_ASYNC);
+
+            trace(config, AHB_COUNTER_BIDS, 1);
         }
         else
         {
@@ -471,16 +612,18 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
 
             auto trans = CharacterDatabase.BeginTransaction();
 
-            if ((auction->bidder) && (AHBplayer->GetGUID() != auction->bidder))
+            if ((auction->bidder) && (_guid != auction->bidder))
             {
                 //
                 // Send the mail to the last bidder
                 //
 
-                sAuctionMgr->SendAuctionOutbiddedMail(auction, auction->buyout, session->GetPlayer(), trans);
+                gOutbidder = _id;
+                sAuctionMgr->SendAuctionOutbiddedMail(auction, auction->buyout, nullptr, trans);
+                gOutbidder = 0;
             }
 
-            auction->bidder = AHBplayer->GetGUID();
+            auction->bidder = _guid;
             auction->bid    = auction->buyout;
 
             // 
@@ -499,23 +642,33 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
             sAuctionMgr->RemoveAItem   (auction->item_guid);
             auctionHouse->RemoveAuction(auction);
 
+            //
+            // The core decides how many statements the mails take
+            //
+
+            gDbStats.Count(AHB_DB_BUY_BUYOUT, AHB_DB_APPEND, uint32(trans->GetSize()));
+
             CharacterDatabase.CommitTransaction(trans);
+            gDbStats.Count(AHB_DB_BUY_BUYOUT, AHB_DB_COMMIT);
+
+            trace(config, AHB_COUNTER_BUYOUTS, 1);
         }
 
+        record(config, AHB_PHASE_PERSISTENCE, clock.Lap());
+
         //
-        // Tracing
+        // Tracing; the auction is gone after a buyout, only the copied values are used
         //
 
-        if (config->TraceBuyer)
+        if (bought)
         {
-            if (bought)
-            {
-                LOG_INFO("module", "AHBot [{}]: Bought , id={}, ah={}, item={}, start={}, current={}, buyout={}", _id, prototype->ItemId, auction->GetHouseId(), auction->item_template, auction->startbid, currentprice, auction->buyout);
-            }
-            else
-            {
-                LOG_INFO("module", "AHBot [{}]: New bid, id={}, ah={}, item={}, start={}, current={}, buyout={}", _id, prototype->ItemId, auction->GetHouseId(), auction->item_template, auction->startbid, currentprice, auction->buyout);
-            }
+            gTracer.Trace  (config->TraceBuyer, AHB_TRACE_BUYOUT, _id, config->GetAHID(), prototype->ItemId, itemCount, currentprice, buyout);
+            gRecorder.Record(AHB_RECORD_BUYOUT, config->GetAHID(), prototype->ItemId, randomPropertyId, itemCount, buyout, currentprice, outBid);
+        }
+        else
+        {
+            gTracer.Trace  (config->TraceBuyer, AHB_TRACE_BID, _id, config->GetAHID(), prototype->ItemId, itemCount, currentprice, bidprice, buyout);
+            gRecorder.Record(AHB_RECORD_BID, config->GetAHID(), prototype->ItemId, randomPropertyId, itemCount, bidprice, currentprice, outBid);
         }
     }
 }
@@ -524,7 +677,7 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
 // This routine performs the selling operations for the bot
 // =============================================================================
 
-void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
+void AuctionHouseBot::Sell(AHBConfig* config, AHBSellPlan& plan)
 {
     // 
     // Check if disabled
@@ -573,7 +726,7 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
 
     bool   aboveMin = false;
     bool   aboveMax = false;
-    uint32 auctions = getNofAuctions(config, auctionHouse, AHBplayer->GetGUID());
+    uint32 auctions = getNofAuctions(config, auctionHouse, _guid);
     uint32 items    = 0;
 
     if (auctions >= minItems)
@@ -613,37 +766,31 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
     // Retrieve the configuration for this run
     // 
 
-    uint32 greyTGcount   = config->GetMaximum(AHB_GREY_TG);
-    uint32 whiteTGcount  = config->GetMaximum(AHB_WHITE_TG);
-    uint32 greenTGcount  = config->GetMaximum(AHB_GREEN_TG);
-    uint32 blueTGcount   = config->GetMaximum(AHB_BLUE_TG);
-    uint32 purpleTGcount = config->GetMaximum(AHB_PURPLE_TG);
-    uint32 orangeTGcount = config->GetMaximum(AHB_ORANGE_TG);
-    uint32 yellowTGcount = config->GetMaximum(AHB_YELLOW_TG);
-
-    uint32 greyIcount    = config->GetMaximum(AHB_GREY_I);
-    uint32 whiteIcount   = config->GetMaximum(AHB_WHITE_I);
-    uint32 greenIcount   = config->GetMaximum(AHB_GREEN_I);
-    uint32 blueIcount    = config->GetMaximum(AHB_BLUE_I);
-    uint32 purpleIcount  = config->GetMaximum(AHB_PURPLE_I);
-    uint32 orangeIcount  = config->GetMaximum(AHB_ORANGE_I);
-    uint32 yellowIcount  = config->GetMaximum(AHB_YELLOW_I);
-
-    uint32 greyTGoods    = config->GetItemCounts(AHB_GREY_TG);
-    uint32 whiteTGoods   = config->GetItemCounts(AHB_WHITE_TG);
-    uint32 greenTGoods   = config->GetItemCounts(AHB_GREEN_TG);
-    uint32 blueTGoods    = config->GetItemCounts(AHB_BLUE_TG);
-    uint32 purpleTGoods  = config->GetItemCounts(AHB_PURPLE_TG);
-    uint32 orangeTGoods  = config->GetItemCounts(AHB_ORANGE_TG);
-    uint32 yellowTGoods  = config->GetItemCounts(AHB_YELLOW_TG);
-
-    uint32 greyItems     = config->GetItemCounts(AHB_GREY_I);
-    uint32 whiteItems    = config->GetItemCounts(AHB_WHITE_I);
-    uint32 greenItems    = config->GetItemCounts(AHB_GREEN_I);
-    uint32 blueItems     = config->GetItemCounts(AHB_BLUE_I);
-    uint32 purpleItems   = config->GetItemCounts(AHB_PURPLE_I);
-    uint32 orangeItems   = config->GetItemCounts(AHB_ORANGE_I);
-    uint32 yellowItems   = config->GetItemCounts(AHB_YELLOW_I);
+    uint32 maxima[AHB_YELLOW_I + 1];
+    uint32 counts[AHB_YELLOW_I + 1];
+
+    for (uint32 category = AHB_GREY_TG; category <= AHB_YELLOW_I; ++category)
+    {
+        maxima[category] = config->GetMaximum(category);
+        counts[category] = config->GetItemCounts(category);
+    }
+
+    // 
+    // Auctions of the bot by template, for the duplicates limit; kept up to date with the new listings
+    // 
+
+    std::unordered_map<uint32, uint32> listedByItem;
+
+    if (config->DuplicatesCount > 0)
+    {
+        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
+        {
+            if (itr->second->owner == _guid)
+            {
+                ++listedByItem[itr->second->item_template];
+            }
+        }
+    }
 
     //
     // Loop variables
@@ -655,133 +802,89 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
     uint32 tooMany   = 0; // Tracing counter
     uint32 loopBrk   = 0; // Tracing counter
     uint32 err       = 0; // Tracing counter
+    uint32 replayed  = 0; // Tracing counter
 
-    for (uint32 cnt = 1; cnt <= items; cnt++)
-    {
-        uint32 choice      = 0;
-        uint32 itemID      = 0;
-        uint32 loopbreaker = 0;
+    // 
+    // Replay the decisions of a mirrored house, or record ours for the next ones
+    // 
 
-        //
-        // Select, in rarity order, a new random item
-        //
+    bool   mirrored = config->SharedSellSource && plan.source == config->SharedSellSource;
+    uint32 next     = 0;
 
-        while (itemID == 0 && loopbreaker <= AUCTION_HOUSE_BOT_LOOP_BREAKER)
-        {
-            loopbreaker++;
+    if (!mirrored)
+    {
+        plan.source = config->SharedSellPlan ? config : NULL;
+        plan.lots.clear();
+    }
 
-            // Poor
+    AHBPhaseClock clock;
 
-            if ((config->GreyItemsBin.size() > 0) && (greyItems < greyIcount))
-            {
-                choice = 0;
-                itemID = getElement(config->GreyItemsBin, urand(0, config->GreyItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            if (itemID == 0 && (config->GreyTradeGoodsBin.size() > 0) && (greyTGoods < greyTGcount))
-            {
-                choice = 7;
-                itemID = getElement(config->GreyTradeGoodsBin, urand(0, config->GreyTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            // Normal
-
-            if (itemID == 0 && (config->WhiteItemsBin.size() > 0) && (whiteItems < whiteIcount))
-            {
-                choice = 1;
-                itemID = getElement(config->WhiteItemsBin, urand(0, config->WhiteItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            if (itemID == 0 && (config->WhiteTradeGoodsBin.size() > 0) && (whiteTGoods < whiteTGcount))
-            {
-                choice = 8;
-                itemID = getElement(config->WhiteTradeGoodsBin, urand(0, config->WhiteTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            // Uncommon
-
-            if (itemID == 0 && (config->GreenItemsBin.size() > 0) && (greenItems < greenIcount))
-            {
-                choice = 2;
-                itemID = getElement(config->GreenItemsBin, urand(0, config->GreenItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            if (itemID == 0 && (config->GreenTradeGoodsBin.size() > 0) && (greenTGoods < greenTGcount))
-            {
-                choice = 9;
-                itemID = getElement(config->GreenTradeGoodsBin, urand(0, config->GreenTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            // Rare
+    for (uint32 cnt = 1; cnt <= items; cnt++)
+    {
+        uint32 category         = 0;
+        uint32 itemID           = 0;
+        int32  randomPropertyId = 0;
+        uint64 buyoutPrice      = 0;
+        uint64 bidPrice         = 0;
+        uint32 stackCount       = 1;
 
-            if (itemID == 0 && (config->BlueItemsBin.size() > 0) && (blueItems < blueIcount))
-            {
-                choice = 3;
-                itemID = getElement(config->BlueItemsBin, urand(0, config->BlueItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+        AHBSellLot const* lot = NULL;
 
-            if (itemID == 0 && (config->BlueTradeGoodsBin.size() > 0) && (blueTGoods < blueTGcount))
-            {
-                choice = 10;
-                itemID = getElement(config->BlueTradeGoodsBin, urand(0, config->BlueTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+        clock.Lap();
 
-            // Epic
+        //
+        // Next lot of the plan whose category still has room here
+        //
 
-            if (itemID == 0 && (config->PurpleItemsBin.size() > 0) && (purpleItems < purpleIcount))
-            {
-                choice = 4;
-                itemID = getElement(config->PurpleItemsBin, urand(0, config->PurpleItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+        while (mirrored && next < plan.lots.size())
+        {
+            AHBSellLot const& candidate = plan.lots[next++];
 
-            if (itemID == 0 && (config->PurpleTradeGoodsBin.size() > 0) && (purpleTGoods < purpleTGcount))
+            if (counts[candidate.category] < maxima[candidate.category])
             {
-                choice = 11;
-                itemID = getElement(config->PurpleTradeGoodsBin, urand(0, config->PurpleTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
+                lot = &candidate;
+                break;
             }
+        }
 
-            // Legendary
+        if (lot)
+        {
+            itemID           = lot->itemID;
+            category         = lot->category;
+            randomPropertyId = lot->randomPropertyId;
+            stackCount       = lot->stackCount;
+        }
+        else
+        {
+            uint32 loopbreaker = 0;
 
-            if (itemID == 0 && (config->OrangeItemsBin.size() > 0) && (orangeItems < orangeIcount))
-            {
-                choice = 5;
-                itemID = getElement(config->OrangeItemsBin, urand(0, config->OrangeItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+            //
+            // Select, in rarity order, a new random item
+            //
 
-            if (itemID == 0 && (config->OrangeTradeGoodsBin.size() > 0) && (orangeTGoods < orangeTGcount))
+            while (itemID == 0 && loopbreaker <= AUCTION_HOUSE_BOT_LOOP_BREAKER)
             {
-                choice = 12;
-                itemID = getElement(config->OrangeTradeGoodsBin, urand(0, config->OrangeTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+                loopbreaker++;
 
-            // Artifact
+                itemID = selectItem(config, listedByItem, counts, maxima, category);
 
-            if (itemID == 0 && (config->YellowItemsBin.size() > 0) && (yellowItems < yellowIcount))
-            {
-                choice = 6;
-                itemID = getElement(config->YellowItemsBin, urand(0, config->YellowItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+                if (itemID == 0)
+                {
+                    binEmpty++;
 
-            if (itemID == 0 && (config->YellowTradeGoodsBin.size() > 0) && (yellowTGoods < yellowTGcount))
-            {
-                choice = 13;
-                itemID = getElement(config->YellowTradeGoodsBin, urand(0, config->YellowTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+                    if (config->DebugOutSeller)
+                    {
+                        LOG_ERROR("module", "AHBot [{}]: No item could be selected from the bins", _id);
+                    }
 
-            if (itemID == 0)
-            {
-                binEmpty++;
-            
-                if (config->DebugOutSeller)
-                {
-                    LOG_ERROR("module", "AHBot [{}]: No item could be selected from the bins", _id);
+                    break;
                 }
-            
-                break;
             }
         }
 
-        if (itemID == 0 || loopbreaker > AUCTION_HOUSE_BOT_LOOP_BREAKER)
+        record(config, AHB_PHASE_SELL_SELECT, clock.Lap());
+
+        if (itemID == 0)
         {
             loopBrk++;
             continue;
@@ -805,631 +908,566 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
             continue;
         }
 
-        Item* item = Item::CreateItem(itemID, 1, AHBplayer);
-
-        if (item == NULL)
+        if (prototype->Quality > AHB_MAX_QUALITY)
         {
             err++;
 
             if (config->DebugOutSeller)
             {
-                LOG_ERROR("module", "AHBot [{}]: could not create item from prototype {}", _id, itemID);
+                LOG_ERROR("module", "AHBot [{}]: Quality {} TOO HIGH for item {}", _id, prototype->Quality, itemID);
             }
 
             continue;
         }
 
-        // 
-        // Start interacting with the item by adding a random property
-        // 
+        if (lot)
+        {
+            // 
+            // The prices of the plan, moved by the perturbation of this house
+            // 
 
-        item->AddToUpdateQueueOf(AHBplayer);
+            uint32 perturbation = minValue(config->SharedSellPerturbation, 100);
+            uint32 factor       = random(100 - perturbation, 100 + perturbation);
 
-        uint32 randomPropertyId = Item::GenerateItemRandomPropertyId(itemID);
+            buyoutPrice = lot->buyoutPrice * factor / 100;
+            bidPrice    = lot->bidPrice    * factor / 100;
 
-        if (randomPropertyId != 0)
-        {
-            item->SetItemRandomProperties(randomPropertyId);
+            replayed++;
         }
-
-        if (prototype->Quality > AHB_MAX_QUALITY)
+        else
         {
-            err++;
-
-            if (config->DebugOutSeller)
-            {
-                LOG_ERROR("module", "AHBot [{}]: Quality {} TOO HIGH for item {}", _id, prototype->Quality, itemID);
-            }
+            // 
+            // Determine the random property and the price. The property comes from the core
+            // generator, outside of the seeded stream of the bot.
+            // 
 
-            item->RemoveFromUpdateQueueOf(AHBplayer);
-            continue;
-        }
+            randomPropertyId = Item::GenerateItemRandomPropertyId(itemID);
 
-        // 
-        // Determine the price
-        // 
+            getPrices(config, prototype, randomPropertyId, bidPrice, buyoutPrice);
 
-        uint64 buyoutPrice = 0;
-        uint64 bidPrice    = 0;
-        uint32 stackCount  = 1;
+            // 
+            // Determine the stack size
+            // 
 
-        if (config->SellAtMarketPrice)
-        {
-            buyoutPrice = config->GetItemPrice(itemID);
-        }
+            uint32 maxStackCount = prototype->GetMaxStackSize();
 
-        if (buyoutPrice == 0)
-        {
-            if (config->SellMethod)
+            if (config->GetMaxStack(prototype->Quality) > 1 && maxStackCount > 1)
+            {
+                stackCount = minValue(getStackCount(config, maxStackCount), config->GetMaxStack(prototype->Quality));
+            }
+            else if (config->GetMaxStack(prototype->Quality) == 0 && maxStackCount > 1)
             {
-                buyoutPrice = prototype->BuyPrice;
+                stackCount = getStackCount(config, maxStackCount);
             }
             else
             {
-                buyoutPrice = prototype->SellPrice;
+                stackCount = 1;
             }
         }
 
-        buyoutPrice = buyoutPrice * urand(config->GetMinPrice(prototype->Quality), config->GetMaxPrice(prototype->Quality));
-        buyoutPrice = buyoutPrice / 100;
+        // 
+        // Determine the auction time
+        // 
 
-        bidPrice    = buyoutPrice * urand(config->GetMinBidPrice(prototype->Quality), config->GetMaxBidPrice(prototype->Quality));
-        bidPrice    = bidPrice / 100;
+        uint32 etime = getElapsedTime(config->ElapsingTimeClass);
 
         // 
-        // Determine the stack size
+        // Determine how many identical stacks are listed together, they share
+        // the prototype, the prices, the time and the deposit
         // 
 
-        if (config->GetMaxStack(prototype->Quality) > 1 && item->GetMaxStackCount() > 1)
-        {
-            stackCount = minValue(getStackCount(config, item->GetMaxStackCount()), config->GetMaxStack(prototype->Quality));
-        }
-        else if (config->GetMaxStack(prototype->Quality) == 0 && item->GetMaxStackCount() > 1)
+        uint32 stacks = 1;
+
+        if (prototype->GetMaxStackSize() > 1)
         {
-            stackCount = getStackCount(config, item->GetMaxStackCount());
+            uint32 room  = maxima[category] > counts[category] ? maxima[category] - counts[category] : 1;
+            uint32 limit = minValue(items - cnt + 1, room);
+
+            stacks = lot ? minValue(lot->stacks, limit) : getBundleSize(config, limit);
         }
-        else
+
+        if (!lot && plan.source == config)
         {
-            stackCount = 1;
+            plan.lots.push_back({ itemID, category, randomPropertyId, stackCount, stacks, bidPrice, buyoutPrice });
         }
 
-        item->SetCount(stackCount);
+        record(config, AHB_PHASE_PRICING, clock.Lap());
 
         // 
-        // Determine the auction time
+        // Create the first item, the deposit is the same for every stack
         // 
 
-        uint32 etime = getElapsedTime(config->ElapsingTimeClass);
+        Item* item = AHBCreateItem(prototype, stackCount, randomPropertyId, _guid);
 
-        // 
-        // Determine the deposit
-        // 
+        if (item == NULL)
+        {
+            err++;
 
-        uint32 dep   = sAuctionMgr->GetAuctionDeposit(ahEntry, etime, item, stackCount);
+            if (config->DebugOutSeller)
+            {
+                LOG_ERROR("module", "AHBot [{}]: could not create item from prototype {}", _id, itemID);
+            }
 
-        // 
-        // Perform the auction
-        // 
+            continue;
+        }
 
-        auto trans = CharacterDatabase.BeginTransaction();
-
-        AuctionEntry* auctionEntry      = new AuctionEntry();
-        auctionEntry->Id                = sObjectMgr->GenerateAuctionID();
-        auctionEntry->houseId           = config->GetAHID();
-        auctionEntry->item_guid         = item->GetGUID();
-        auctionEntry->item_template     = item->GetEntry();
-        auctionEntry->itemCount         = item->GetCount();
-        auctionEntry->owner             = AHBplayer->GetGUID();
-        auctionEntry->startbid          = bidPrice * stackCount;
-        auctionEntry->buyout            = buyoutPrice * stackCount;
-        auctionEntry->bid               = 0;
-        auctionEntry->deposit           = dep;
-        auctionEntry->expire_time       = (time_t)etime + time(NULL);
-        auctionEntry->auctionHouseEntry = ahEntry;
-
-        item->SaveToDB(trans);
-        item->RemoveFromUpdateQueueOf(AHBplayer);
-        sAuctionMgr->AddAItem(item);
-        auctionHouse->AddAuction(auctionEntry);
-        auctionEntry->SaveToDB(trans);
+        uint32 dep = sAuctionMgr->GetAuctionDeposit(ahEntry, etime, item, stackCount);
 
-        CharacterDatabase.CommitTransaction(trans);
+        record(config, AHB_PHASE_ITEM_CREATE, clock.Lap());
 
         // 
-        // Increments the number of items presents in the auction
+        // Perform the auctions
         // 
 
-        switch (choice)
-        {
-        case 0:
-            ++greyItems;
-            break;
-
-        case 1:
-            ++whiteItems;
-            break;
-
-        case 2:
-            ++greenItems;
-            break;
+        auto   trans  = CharacterDatabase.BeginTransaction();
+        uint32 listed = 0;
 
-        case 3:
-            ++blueItems;
-            break;
-
-        case 4:
-            ++purpleItems;
-            break;
+        for (uint32 stack = 0; stack < stacks; ++stack)
+        {
+            if (stack > 0)
+            {
+                item = AHBCreateItem(prototype, stackCount, randomPropertyId, _guid);
 
-        case 5:
-            ++orangeItems;
-            break;
+                if (item == NULL)
+                {
+                    err++;
+                    break;
+                }
+            }
 
-        case 6:
-            ++yellowItems;
-            break;
+            AuctionEntry* auctionEntry      = new AuctionEntry();
+            auctionEntry->Id                = sObjectMgr->GenerateAuctionID();
+            auctionEntry->houseId           = config->GetAHID();
+            auctionEntry->item_guid         = item->GetGUID();
+            auctionEntry->item_template     = item->GetEntry();
+            auctionEntry->itemCount         = item->GetCount();
+            auctionEntry->owner             = _guid;
+            auctionEntry->startbid          = bidPrice * stackCount;
+            auctionEntry->buyout            = buyoutPrice * stackCount;
+            auctionEntry->bid               = 0;
+            auctionEntry->deposit           = dep;
+            auctionEntry->expire_time       = (time_t)etime + time(NULL);
+            auctionEntry->auctionHouseEntry = ahEntry;
+
+            item->SaveToDB(trans);
+            sAuctionMgr->AddAItem(item);
+            auctionHouse->AddAuction(auctionEntry);
+            auctionEntry->SaveToDB(trans);
 
-        case 7:
-            ++greyTGoods;
-            break;
+            // 
+            // Increments the number of items presents in the auction
+            // 
 
-        case 8:
-            ++whiteTGoods;
-            break;
+            ++counts[category];
 
-        case 9:
-            ++greenTGoods;
-            break;
+            noSold++;
+            listed++;
 
-        case 10:
-            ++blueTGoods;
-            break;
-
-        case 11:
-            ++purpleTGoods;
-            break;
+            gTracer.Trace(config->TraceSeller, AHB_TRACE_LISTING, _id, config->GetAHID(), itemID, stackCount, auctionEntry->startbid, auctionEntry->buyout);
+            gRecorder.Record(AHB_RECORD_LISTING, config->GetAHID(), itemID, randomPropertyId, stackCount, auctionEntry->buyout);
+        }
 
-        case 12:
-            ++orangeTGoods;
-            break;
+        gDbStats.Count(AHB_DB_SELL_LISTING, AHB_DB_APPEND, uint32(trans->GetSize()));
 
-        case 13:
-            ++yellowTGoods;
-            break;
+        CharacterDatabase.CommitTransaction(trans);
+        gDbStats.Count(AHB_DB_SELL_LISTING, AHB_DB_COMMIT);
 
-        default:
-            break;
+        if (config->DuplicatesCount > 0)
+        {
+            listedByItem[itemID] += listed;
         }
 
-        noSold++;
+        record(config, AHB_PHASE_DB_ENQUEUE, clock.Lap());
 
-        if (config->TraceSeller)
-        {
-            LOG_INFO("module", "AHBot [{}]: New stack ah={}, id={}, stack={}, bid={}, buyout={}", _id, config->GetAHID(), itemID, stackCount, auctionEntry->startbid, auctionEntry->buyout);
-        }
+        // 
+        // The extra stacks count against the items of this cycle
+        // 
+
+        cnt += listed - 1;
     }
 
-    if (config->TraceSeller)
+    trace(config, AHB_COUNTER_NO_SOLD  , noSold);
+    trace(config, AHB_COUNTER_BIN_EMPTY, binEmpty);
+    trace(config, AHB_COUNTER_LOOP_BRK , loopBrk);
+    trace(config, AHB_COUNTER_ERR      , err);
+
+    if (mirrored && config->DebugOutSeller)
     {
-        LOG_INFO("module", "AHBot [{}]: auctionhouse {}, req={}, sold={}, aboveMin={}, aboveMax={}, loopBrk={}, noNeed={}, tooMany={}, binEmpty={}, err={}", _id, config->GetAHID(), items, noSold, aboveMin, aboveMax, loopBrk, noNeed, tooMany, binEmpty, err);
+        LOG_INFO("module", "AHBot [{}]: {} lots replayed from the plan of the house {}, {} listings", _id, replayed, plan.source->GetAHID(), noSold);
     }
+
+    gTracer.Trace(config->TraceSeller, AHB_TRACE_SELL_CYCLE, _id, config->GetAHID(), items, noSold, loopBrk, binEmpty, err);
 }
 
 // =============================================================================
-// Perform an update cycle
+// Dry run of the selling and buying decisions against generated auctions that
+// stand in for the house of the core: nothing is created, bid or written, only
+// the time spent deciding is measured.
 // =============================================================================
 
-void AuctionHouseBot::Update()
+void AuctionHouseBot::Benchmark(AHBConfig* config, ItemTemplateContainer const& store, std::vector<AHBSyntheticAuction> const& auctions, std::vector<std::string>& lines)
 {
-    time_t _newrun = time(NULL);
+    auto report = [&lines](char const* name, uint32 operations, uint64 us)
+    {
+        lines.push_back(Acore::StringFormat("  {:<14} n={:<8} total={}us per op={}ns", name, operations, us, operations ? us * 1000 / operations : 0));
+    };
+
+    AHBPhaseClock clock;
 
     //
-    // If no configuration is associated, then stop here
+    // Auctions of the bot by template, once per selling cycle
     //
 
-    if (!_allianceConfig && !_hordeConfig && !_neutralConfig)
+    std::unordered_map<uint32, uint32> listed;
+
+    for (AHBSyntheticAuction const& auction : auctions)
     {
-        return;
+        if (auction.owner == _id)
+        {
+            ++listed[auction.item];
+        }
     }
 
+    report("sell.listed", auctions.size(), clock.Lap());
+
     //
-    // Preprare for operation
+    // Item selection, the counts being reset once every category is full
     //
 
-    std::string accountName = "AuctionHouseBot" + std::to_string(_account);
+    uint32 maxima[AHB_YELLOW_I + 1];
+    uint32 counts[AHB_YELLOW_I + 1];
 
-    WorldSession _session(_account, std::move(accountName), nullptr, SEC_PLAYER, sWorld->getIntConfig(CONFIG_EXPANSION), 0, LOCALE_enUS, 0, false, false, 0);
+    for (uint32 category = AHB_GREY_TG; category <= AHB_YELLOW_I; ++category)
+    {
+        maxima[category] = config->GetMaximum(category);
+        counts[category] = 0;
+    }
 
-    Player _AHBplayer(&_session);
-    _AHBplayer.Initialize(_id);
+    std::vector<uint32> selected;
+    selected.reserve(AHB_BENCHMARK_SELECTIONS);
 
-    ObjectAccessor::AddObject(&_AHBplayer);
+    clock.Lap();
 
-    //
-    // Perform update for the factions markets
-    //
-
-    if (!sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
+    for (uint32 i = 0; i < AHB_BENCHMARK_SELECTIONS; ++i)
     {
-        //
-        // Alliance
-        //
+        uint32 category = 0;
+        uint32 itemID   = selectItem(config, listed, counts, maxima, category);
 
-        if (_allianceConfig)
+        if (itemID == 0)
         {
-            Sell(&_AHBplayer, _allianceConfig);
-
-            if (((_newrun - _lastrun_a_sec) >= (_allianceConfig->GetBiddingInterval() * MINUTE)) && (_allianceConfig->GetBidsPerInterval() > 0))
+            for (uint32 category = AHB_GREY_TG; category <= AHB_YELLOW_I; ++category)
             {
-                Buy(&_AHBplayer, _allianceConfig, &_session);
-                _lastrun_a_sec = _newrun;
+                counts[category] = 0;
             }
+
+            continue;
         }
 
-        //
-        // Horde
-        //
+        ++counts[category];
+        selected.push_back(itemID);
+    }
 
-        if (_hordeConfig)
+    report("sell.select", AHB_BENCHMARK_SELECTIONS, clock.Lap());
+
+    //
+    // Pricing of the selected items
+    //
+
+    for (uint32 itemID : selected)
+    {
+        ItemTemplateContainer::const_iterator prototype = store.find(itemID);
+
+        if (prototype != store.end())
         {
-            Sell(&_AHBplayer, _hordeConfig);
+            uint64 bidPrice;
+            uint64 buyoutPrice;
 
-            if (((_newrun - _lastrun_h_sec) >= (_hordeConfig->GetBiddingInterval() * MINUTE)) && (_hordeConfig->GetBidsPerInterval() > 0))
-            {
-                Buy(&_AHBplayer, _hordeConfig, &_session);
-                _lastrun_h_sec = _newrun;
-            }
+            getPrices(config, &prototype->second, 0, bidPrice, buyoutPrice);
         }
-
     }
 
+    report("sell.pricing", selected.size(), clock.Lap());
+
     //
-    // Neutral
+    // Evaluation of every auction of the house
     //
 
-    if (_neutralConfig)
+    uint32 bids = 0;
+
+    for (AHBSyntheticAuction const& auction : auctions)
     {
-        Sell(&_AHBplayer, _neutralConfig);
+        ItemTemplateContainer::const_iterator prototype = store.find(auction.item);
 
-        if (((_newrun - _lastrun_n_sec) >= (_neutralConfig->GetBiddingInterval() * MINUTE)) && (_neutralConfig->GetBidsPerInterval() > 0))
+        if (prototype == store.end())
         {
-            Buy(&_AHBplayer, _neutralConfig, &_session);
-            _lastrun_n_sec = _newrun;
+            continue;
+        }
+
+        long double bidMax = 0;
+
+        if (getBidPrice(config, &prototype->second, auction.count, 0, auction.bid ? auction.bid : auction.startbid, auction.outBid, bidMax) != 0)
+        {
+            bids++;
         }
     }
 
-    ObjectAccessor::RemoveObject(&_AHBplayer);
+    report("buy.evaluate", auctions.size(), clock.Lap());
+
+    lines.push_back(Acore::StringFormat("  {} items selected, {} bids would have been placed", selected.size(), bids));
 }
 
 // =============================================================================
-// Execute commands coming from the console
+// Feeds a recorded event stream through the market statistics, the selection
+// and the pricing of the given configuration, which should be a scratch copy:
+// its statistics and counts are modified. Nothing touches the live houses, so
+// it runs as a job; only the item templates of the core are read.
 // =============================================================================
 
-void AuctionHouseBot::Commands(AHBotCommand command, uint32 ahMapID, uint32 col, char* args)
+void AuctionHouseBot::Replay(AHBConfig* config, std::vector<AHBRecord> const& records, std::vector<std::string>& lines)
 {
-    //
-    // Retrieve the auction house configuration
-    //
+    uint64 events[AHB_RECORD_MAX] = { };
 
-    AHBConfig *config = NULL;
+    uint32 firstTime    = 0;
+    uint32 lastTime     = 0;
+    uint32 selected     = 0;
+    uint64 recorded     = 0; // Buyouts of the recorded listings
+    uint64 simulated    = 0; // Buyouts of the same listings, priced again
+    uint32 bids         = 0; // Recorded bids and buyouts the buyer would still place
+    uint64 recordedBid  = 0;
+    uint64 simulatedBid = 0;
 
-    switch (ahMapID)
+    uint32 maxima[AHB_YELLOW_I + 1];
+    uint32 counts[AHB_YELLOW_I + 1];
+
+    for (uint32 category = AHB_GREY_TG; category <= AHB_YELLOW_I; ++category)
     {
-    case 2:
-        config = _allianceConfig;
-        break;
-    case 6:
-        config = _hordeConfig;
-        break;
-    default:
-        config = _neutralConfig;
-        break;
+        maxima[category] = config->GetMaximum(category);
     }
 
     //
-    // Retrive the item quality
+    // The auctions of the bot are not known from the records, no duplicates limit applies
     //
 
-    std::string color;
-
-    switch (col)
-    {
-    case AHB_GREY:
-        color = "grey";
-        break;
-    case AHB_WHITE:
-        color = "white";
-        break;
-    case AHB_GREEN:
-        color = "green";
-        break;
-    case AHB_BLUE:
-        color = "blue";
-        break;
-    case AHB_PURPLE:
-        color = "purple";
-        break;
-    case AHB_ORANGE:
-        color = "orange";
-        break;
-    case AHB_YELLOW:
-        color = "yellow";
-        break;
-    default:
-        break;
-    }
+    std::unordered_map<uint32, uint32> const listed;
 
-    //
-    // Perform the command
-    //
+    AHBPhaseClock clock;
 
-    switch (command)
+    for (AHBRecord const& entry : records)
     {
-    case AHBotCommand::buyer:
-    {
-        char* param1 = strtok(args, " ");
-        uint32 state = (uint32)strtoul(param1, NULL, 0);
-
-        if (state == 0)
-        {
-            _allianceConfig->AHBBuyer = false;
-            _hordeConfig->AHBBuyer    = false;
-            _neutralConfig->AHBBuyer  = false;
-        }
-        else
+        if (gJob.Cancelled())
         {
-            _allianceConfig->AHBBuyer = true;
-            _hordeConfig->AHBBuyer    = true;
-            _neutralConfig->AHBBuyer  = true;
+            break;
         }
 
-        break;
-    }
-    case AHBotCommand::seller:
-    {
-        char* param1 = strtok(args, " ");
-        uint32 state = (uint32)strtoul(param1, NULL, 0);
-
-        if (state == 0)
+        if (entry.house != config->GetAHID() || entry.event >= AHB_RECORD_MAX)
         {
-            _allianceConfig->AHBSeller = false;
-            _hordeConfig->AHBSeller    = false;
-            _neutralConfig->AHBSeller  = false;
+            continue;
         }
-        else
+
+        if (firstTime == 0)
         {
-            _allianceConfig->AHBSeller = true;
-            _hordeConfig->AHBSeller    = true;
-            _neutralConfig->AHBSeller  = true;
+            firstTime = entry.time;
         }
 
-        break;
-    }
-    case AHBotCommand::useMarketPrice:
-    {
-        char* param1 = strtok(args, " ");
-        uint32 state = (uint32)strtoul(param1, NULL, 0);
+        lastTime = entry.time;
+
+        events[entry.event]++;
+
+        ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(entry.item);
 
-        if (state == 0)
+        if (!prototype)
         {
-            _allianceConfig->SellAtMarketPrice = false;
-            _hordeConfig->SellAtMarketPrice    = false;
-            _neutralConfig->SellAtMarketPrice  = false;
+            continue;
         }
-        else
+
+        switch (entry.event)
         {
-            _allianceConfig->SellAtMarketPrice = true;
-            _hordeConfig->SellAtMarketPrice    = true;
-            _neutralConfig->SellAtMarketPrice  = true;
-        }
+        case AHB_RECORD_ADD:
+            config->IncItemCounts(prototype->Class, prototype->Quality);
+            break;
 
-        break;
-    }
-    case AHBotCommand::ahexpire:
-    {
-        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAHFID());
+        case AHB_RECORD_REMOVE:
+        {
+            //
+            // The auctions listed before the recording started are not counted
+            //
 
-        AuctionHouseObject::AuctionEntryMap::iterator itr;
-        itr = auctionHouse->GetAuctionsBegin();
+            uint32 category = prototype->Class == ITEM_CLASS_TRADE_GOODS ? prototype->Quality : prototype->Quality + 7;
 
-        //
-        // Iterate through all the autions and if they belong to the bot, make them expired
-        //
+            if (config->GetItemCounts(category) > 0)
+            {
+                config->DecItemCounts(category);
+            }
 
-        while (itr != auctionHouse->GetAuctionsEnd())
+            break;
+        }
+
+        case AHB_RECORD_SUCCESSFUL:
+        case AHB_RECORD_EXPIRE:
+            config->UpdateItemStats(entry.item, entry.random, entry.count, entry.price, _random);
+            break;
+
+        case AHB_RECORD_LISTING:
         {
-            if (itr->second->owner.GetCounter() == _id)
+            //
+            // Select an item as the seller would have at that time, then price the recorded one
+            //
+
+            for (uint32 category = AHB_GREY_TG; category <= AHB_YELLOW_I; ++category)
             {
-                // Expired NOW.
-                itr->second->expire_time = GameTime::GetGameTime().count();
+                counts[category] = config->GetItemCounts(category);
+            }
 
-                uint32 id                = itr->second->Id;
-                uint32 expire_time       = itr->second->expire_time;
+            uint32 category = 0;
 
-                CharacterDatabase.Execute("UPDATE auctionhouse SET time = '{}' WHERE id = '{}'", expire_time, id);
+            if (selectItem(config, listed, counts, maxima, category) != 0)
+            {
+                selected++;
             }
 
-            ++itr;
-        }
+            uint64 bidPrice;
+            uint64 buyoutPrice;
 
-        break;
-    }
-    case AHBotCommand::minitems:
-    {
-        char * param1   = strtok(args, " ");
-        uint32 minItems = (uint32) strtoul(param1, NULL, 0);
+            getPrices(config, prototype, entry.random, bidPrice, buyoutPrice);
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET minitems = '{}' WHERE auctionhouse = '{}'", minItems, ahMapID);
+            recorded  += entry.price;
+            simulated += buyoutPrice * entry.count;
+            break;
+        }
 
-        config->SetMinItems(minItems);
+        case AHB_RECORD_BID:
+        case AHB_RECORD_BUYOUT:
+        {
+            long double bidMax   = 0;
+            uint32      bidprice = getBidPrice(config, prototype, entry.count, entry.random, entry.current, entry.outBid, bidMax);
 
-        break;
-    }
-    case AHBotCommand::maxitems:
-    {
-        char * param1   = strtok(args, " ");
-        uint32 maxItems = (uint32) strtoul(param1, NULL, 0);
+            recordedBid += entry.price;
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET maxitems = '{}' WHERE auctionhouse = '{}'", maxItems, ahMapID);
+            if (bidprice != 0)
+            {
+                bids++;
+                simulatedBid += bidprice;
+            }
 
-        config->SetMaxItems(maxItems);
-        config->CalculatePercents();
-        break;
+            break;
+        }
+
+        default:
+            break;
+        }
     }
-    case AHBotCommand::percentages:
-    {
-        char * param1   = strtok(args, " ");
-        char * param2   = strtok(NULL, " ");
-        char * param3   = strtok(NULL, " ");
-        char * param4   = strtok(NULL, " ");
-        char * param5   = strtok(NULL, " ");
-        char * param6   = strtok(NULL, " ");
-        char * param7   = strtok(NULL, " ");
-        char * param8   = strtok(NULL, " ");
-        char * param9   = strtok(NULL, " ");
-        char * param10  = strtok(NULL, " ");
-        char * param11  = strtok(NULL, " ");
-        char * param12  = strtok(NULL, " ");
-        char * param13  = strtok(NULL, " ");
-        char * param14  = strtok(NULL, " ");
-
-        uint32 greytg   = (uint32) strtoul(param1, NULL, 0);
-        uint32 whitetg  = (uint32) strtoul(param2, NULL, 0);
-        uint32 greentg  = (uint32) strtoul(param3, NULL, 0);
-        uint32 bluetg   = (uint32) strtoul(param4, NULL, 0);
-        uint32 purpletg = (uint32) strtoul(param5, NULL, 0);
-        uint32 orangetg = (uint32) strtoul(param6, NULL, 0);
-        uint32 yellowtg = (uint32) strtoul(param7, NULL, 0);
-        uint32 greyi    = (uint32) strtoul(param8, NULL, 0);
-        uint32 whitei   = (uint32) strtoul(param9, NULL, 0);
-        uint32 greeni   = (uint32) strtoul(param10, NULL, 0);
-        uint32 bluei    = (uint32) strtoul(param11, NULL, 0);
-        uint32 purplei  = (uint32) strtoul(param12, NULL, 0);
-        uint32 orangei  = (uint32) strtoul(param13, NULL, 0);
-        uint32 yellowi  = (uint32) strtoul(param14, NULL, 0);
 
-        //
-        // Setup the percentage in the configuration first, so validity test can be performed
-        //
+    uint32 us   = clock.Lap();
+    uint64 span = lastTime > firstTime ? lastTime - firstTime : 0;
 
-        config->SetPercentages(greytg, whitetg, greentg, bluetg, purpletg, orangetg, yellowtg, greyi, whitei, greeni, bluei, purplei, orangei, yellowi);
+    lines.push_back(Acore::StringFormat("Auction house {}: {} seconds of traffic replayed in {}us, {}x real time", config->GetAHID(), span, us, us ? span * 1000000 / us : 0));
 
-        //
-        // Save the results into the database (after the tests)
-        //
+    for (uint32 event = 0; event < AHB_RECORD_MAX; ++event)
+    {
+        lines.push_back(Acore::StringFormat("  {:<12} {}", AHBRecorder::GetEventName(event), events[event]));
+    }
 
-        auto trans = WorldDatabase.BeginTransaction();
-
-        trans->Append("UPDATE mod_auctionhousebot SET percentgreytradegoods   = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_GREY_TG)  , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentwhitetradegoods  = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_WHITE_TG) , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentgreentradegoods  = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_GREEN_TG) , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentbluetradegoods   = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_BLUE_TG)  , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentpurpletradegoods = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_PURPLE_TG), ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentorangetradegoods = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_ORANGE_TG), ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentyellowtradegoods = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_YELLOW_TG), ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentgreyitems        = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_GREY_I)   , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentwhiteitems       = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_WHITE_I)  , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentgreenitems       = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_GREEN_I)  , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentblueitems        = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_BLUE_I)   , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentpurpleitems      = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_PURPLE_I) , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentorangeitems      = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_ORANGE_I) , ahMapID);
-        trans->Append("UPDATE mod_auctionhousebot SET percentyellowitems      = '{}' WHERE auctionhouse = '{}'", config->GetPercentages(AHB_YELLOW_I) , ahMapID);
-
-        WorldDatabase.CommitTransaction(trans);
+    lines.push_back(Acore::StringFormat("  market prices {}, selections {}/{}", config->GetItemStatsCount(), selected, events[AHB_RECORD_LISTING]));
+    lines.push_back(Acore::StringFormat("  listings buyout recorded={} simulated={}", recorded, simulated));
+    lines.push_back(Acore::StringFormat("  bids placed {}/{}, recorded={} simulated={}", bids, events[AHB_RECORD_BID] + events[AHB_RECORD_BUYOUT], recordedBid, simulatedBid));
+}
 
-        break;
-    }
-    case AHBotCommand::minprice:
-    {
-        char * param1   = strtok(args, " ");
-        uint32 minPrice = (uint32) strtoul(param1, NULL, 0);
+// =============================================================================
+// Perform an update cycle
+// =============================================================================
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET minprice{} = '{}' WHERE auctionhouse = '{}'", color, minPrice, ahMapID);
+void AuctionHouseBot::Update()
+{
+    time_t _newrun = time(NULL);
 
-        config->SetMinPrice(col, minPrice);
+    //
+    // If no configuration is associated, then stop here
+    //
 
-        break;
-    }
-    case AHBotCommand::maxprice:
+    if (!_allianceConfig && !_hordeConfig && !_neutralConfig)
     {
-        char * param1   = strtok(args, " ");
-        uint32 maxPrice = (uint32) strtoul(param1, NULL, 0);
+        return;
+    }
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET maxprice{} = '{}' WHERE auctionhouse = '{}'", color, maxPrice, ahMapID);
+    //
+    // Preprare for operation
+    //
 
-        config->SetMaxPrice(col, maxPrice);
+    AHBPhaseClock cycle;
+    AHBPhaseClock clock;
 
-        break;
-    }
-    case AHBotCommand::minbidprice:
-    {
-        char * param1      = strtok(args, " ");
-        uint32 minBidPrice = (uint32) strtoul(param1, NULL, 0);
+    //
+    // Selling decisions shared by the houses with mirrored settings
+    //
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET minbidprice{} = '{}' WHERE auctionhouse = '{}'", color, minBidPrice, ahMapID);
+    AHBSellPlan plan;
 
-        config->SetMinBidPrice(col, minBidPrice);
+    //
+    // Perform update for the factions markets
+    //
 
-        break;
-    }
-    case AHBotCommand::maxbidprice:
+    if (!sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
     {
-        char * param1      = strtok(args, " ");
-        uint32 maxBidPrice = (uint32) strtoul(param1, NULL, 0);
+        //
+        // Alliance
+        //
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET maxbidprice{} = '{}' WHERE auctionhouse = '{}'", color, maxBidPrice, ahMapID);
+        if (_allianceConfig)
+        {
+            clock.Lap();
 
-        config->SetMaxBidPrice(col, maxBidPrice);
+            Sell(_allianceConfig, plan);
 
-        break;
-    }
-    case AHBotCommand::maxstack:
-    {
-        char * param1   = strtok(args, " ");
-        uint32 maxStack = (uint32) strtoul(param1, NULL, 0);
+            if (((_newrun - _lastrun_a_sec) >= (_allianceConfig->GetBiddingInterval() * MINUTE)) && (_allianceConfig->GetBidsPerInterval() > 0))
+            {
+                Buy(_allianceConfig);
+                _lastrun_a_sec = _newrun;
+            }
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET maxstack{} = '{}' WHERE auctionhouse = '{}'", color, maxStack, ahMapID);
+            _allianceConfig->Stats.Record(AHB_PHASE_CYCLE, clock.Lap());
+        }
 
-        config->SetMaxStack(col, maxStack);
+        //
+        // Horde
+        //
 
-        break;
-    }
-    case AHBotCommand::buyerprice:
-    {
-        char * param1     = strtok(args, " ");
-        uint32 buyerPrice = (uint32) strtoul(param1, NULL, 0);
+        if (_hordeConfig)
+        {
+            clock.Lap();
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET buyerprice{} = '{}' WHERE auctionhouse = '{}'", color, buyerPrice, ahMapID);
+            Sell(_hordeConfig, plan);
 
-        config->SetBuyerPrice(col, buyerPrice);
+            if (((_newrun - _lastrun_h_sec) >= (_hordeConfig->GetBiddingInterval() * MINUTE)) && (_hordeConfig->GetBidsPerInterval() > 0))
+            {
+                Buy(_hordeConfig);
+                _lastrun_h_sec = _newrun;
+            }
 
-        break;
-    }
-    case AHBotCommand::bidinterval:
-    {
-        char * param1      = strtok(args, " ");
-        uint32 bidInterval = (uint32) strtoul(param1, NULL, 0);
+            _hordeConfig->Stats.Record(AHB_PHASE_CYCLE, clock.Lap());
+        }
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET buyerbiddinginterval = '{}' WHERE auctionhouse = '{}'", bidInterval, ahMapID);
+    }
 
-        config->SetBiddingInterval(bidInterval);
+    //
+    // Neutral
+    //
 
-        break;
-    }
-    case AHBotCommand::bidsperinterval:
+    if (_neutralConfig)
     {
-        char * param1          = strtok(args, " ");
-        uint32 bidsPerInterval = (uint32) strtoul(param1, NULL, 0);
+        clock.Lap();
 
-        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET buyerbidsperinterval = '{}' WHERE auctionhouse = '{}'", bidsPerInterval, ahMapID);
+        Sell(_neutralConfig, plan);
 
-        config->SetBidsPerInterval(bidsPerInterval);
+        if (((_newrun - _lastrun_n_sec) >= (_neutralConfig->GetBiddingInterval() * MINUTE)) && (_neutralConfig->GetBidsPerInterval() > 0))
+        {
+            Buy(_neutralConfig);
+            _lastrun_n_sec = _newrun;
+        }
 
-        break;
-    }
-    default:
-        break;
+        _neutralConfig->Stats.Record(AHB_PHASE_CYCLE, clock.Lap());
     }
+
+    _stats.Record(AHB_PHASE_CYCLE, cycle.Lap());
 }
 
 // =============================================================================
@@ -1446,6 +1484,14 @@ void AuctionHouseBot::Initialize(AHBConfig* allianceConfig, AHBConfig* hordeConf
     _hordeConfig    = hordeConfig;
     _neutralConfig  = neutralConfig;
 
+    //
+    // Resume the bidding intervals where the checkpoint left them
+    //
+
+    _lastrun_a_sec  = _allianceConfig->GetCheckpointRun(_id, _lastrun_a_sec);
+    _lastrun_h_sec  = _hordeConfig->GetCheckpointRun   (_id, _lastrun_h_sec);
+    _lastrun_n_sec  = _neutralConfig->GetCheckpointRun (_id, _lastrun_n_sec);
+
     //
     // Done
     //
@@ -20,24 +20,55 @@
 #ifndef AUCTION_HOUSE_BOT_H
 #define AUCTION_HOUSE_BOT_H
 
+#include <unordered_map>
+
 #include "Common.h"
 #include "ObjectGuid.h"
 #include "AuctionHouseMgr.h"
 
 #include "AuctionHouseBotCommon.h"
 #include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotRandom.h"
+#include "AuctionHouseBotRecorder.h"
+#include "AuctionHouseBotStats.h"
+#include "AuctionHouseBotTracer.h"
 
 struct AuctionEntry;
-class  Player;
-class  WorldSession;
+struct AHBSyntheticAuction;
+struct ItemTemplate;
 
 #define AUCTION_HOUSE_BOT_LOOP_BREAKER 32
+#define AHB_BENCHMARK_SELECTIONS       10000
+
+//
+// Selling decisions of a cycle, replayed by the houses mirroring the one that took them
+//
+
+struct AHBSellLot
+{
+    uint32 itemID;
+    uint32 category;
+    int32  randomPropertyId;
+    uint32 stackCount;
+    uint32 stacks;
+    uint64 bidPrice;
+    uint64 buyoutPrice;
+};
+
+struct AHBSellPlan
+{
+    AHBConfig*              source;
+    std::vector<AHBSellLot> lots;
+
+    AHBSellPlan() : source(NULL) { }
+};
 
 class AuctionHouseBot
 {
 private:
     uint32     _account;
     uint32     _id;
+    ObjectGuid _guid;
 
     AHBConfig* _allianceConfig;
     AHBConfig* _hordeConfig;
@@ -47,12 +78,20 @@ private:
     time_t     _lastrun_h_sec;
     time_t     _lastrun_n_sec;
 
+    AHBStats   _stats;
+
+    //
+    // Own random stream, reproducible when seeded
+    //
+
+    AHBRandom  _random;
+
     //
     // Main operations
     //
 
-    void Sell(Player *AHBplayer, AHBConfig *config);
-    void Buy (Player *AHBplayer, AHBConfig *config, WorldSession *session);
+    void Sell(AHBConfig* config, AHBSellPlan& plan);
+    void Buy (AHBConfig* config);
 
     //
     // Utilities
@@ -62,8 +101,22 @@ private:
 
     uint32 getNofAuctions(AHBConfig* config, AuctionHouseObject* auctionHouse, ObjectGuid guid);
     uint32 getStackCount(AHBConfig* config, uint32 max);
+    uint32 getBundleSize(AHBConfig* config, uint32 max);
     uint32 getElapsedTime(uint32 timeClass);
-    uint32 getElement(std::set<uint32> set, int index, uint32 botId, uint32 maxDup, AuctionHouseObject* auctionHouse);
+    uint32 getElement(std::set<uint32> const& set, int index, uint32 maxDup, std::unordered_map<uint32, uint32> const& listed);
+
+    //
+    // Decisions, free of side effects apart from the random numbers
+    //
+
+    uint32 selectItem (AHBConfig* config, std::unordered_map<uint32, uint32> const& listed, uint32 const* counts, uint32 const* maxima, uint32& category);
+    void   getPrices  (AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, uint64& bidPrice, uint64& buyoutPrice);
+    uint32 getBidPrice(AHBConfig* config, ItemTemplate const* prototype, uint32 itemCount, int32 randomPropertyId, uint32 currentprice, uint32 outBid, long double& bidMax);
+
+    uint32 random(uint32 min, uint32 max);
+
+    void   record(AHBConfig* config, AHBPhase phase, uint32 us);
+    void   trace (AHBConfig* config, AHBCounter counter, uint32 value);
 
 public:
     AuctionHouseBot(uint32 account, uint32 id);
@@ -72,9 +125,14 @@ public:
     void Initialize(AHBConfig* allianceConfig, AHBConfig* hordeConfig, AHBConfig* neutralConfig);
     void Update();
 
-    void Commands(AHBotCommand command, uint32 ahMapID, uint32 col, char* args);
+    void Seed     (uint32 seed);
+    void Benchmark(AHBConfig* config, ItemTemplateContainer const& store, std::vector<AHBSyntheticAuction> const& auctions, std::vector<std::string>& lines);
+    void Replay   (AHBConfig* config, std::vector<AHBRecord> const& records, std::vector<std::string>& lines);
+
+    time_t GetLastRun(AHBConfig* config);
 
     ObjectGuid::LowType GetAHBplayerGUID() { return _id; };
+    AHBStats const&     GetStats()         { return _stats; };
 };
 
 #endif // AUCTION_HOUSE_BOT_H
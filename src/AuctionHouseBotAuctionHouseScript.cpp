@@ -8,12 +8,31 @@
 #include "AuctionHouseBot.h"
 #include "AuctionHouseBotCommon.h"
 #include "AuctionHouseBotAuctionHouseScript.h"
+#include "AuctionHouseBotRandom.h"
+#include "AuctionHouseBotRecorder.h"
 
 AHBot_AuctionHouseScript::AHBot_AuctionHouseScript() : AuctionHouseScript("AHBot_AuctionHouseScript")
 {
 
 }
 
+int32 AHBot_AuctionHouseScript::getRandomPropertyId(AuctionEntry* auction)
+{
+    //
+    // The item may already be gone from the auction house storage; the statistics
+    // then only go to the aggregate of the template.
+    //
+
+    Item* item = sAuctionMgr->GetAItem(auction->item_guid);
+
+    if (!item)
+    {
+        return 0;
+    }
+
+    return item->GetItemRandomPropertyId();
+}
+
 void AHBot_AuctionHouseScript::OnBeforeAuctionHouseMgrSendAuctionSuccessfulMail(
     AuctionHouseMgr*,                /*auctionHouseMgr*/
     AuctionEntry*,                   /*auction*/
@@ -24,6 +43,8 @@ void AHBot_AuctionHouseScript::OnBeforeAuctionHouseMgrSendAuctionSuccessfulMail(
     bool& updateAchievementCriteria,
     bool&                            /*sendMail*/)
 {
+    AHBHookTimer timer(AHB_HOOK_SUCCESSFUL_MAIL);
+
     if (owner && gBotsId.find(owner->GetGUID().GetCounter()) != gBotsId.end())
     {
         sendNotification          = false;
@@ -39,6 +60,8 @@ void AHBot_AuctionHouseScript::OnBeforeAuctionHouseMgrSendAuctionExpiredMail(
     bool& sendNotification,
     bool&                   /* sendMail */)
 {
+    AHBHookTimer timer(AHB_HOOK_EXPIRED_MAIL);
+
     if (owner && gBotsId.find(owner->GetGUID().GetCounter()) != gBotsId.end())
     {
         sendNotification = false;
@@ -55,31 +78,29 @@ void AHBot_AuctionHouseScript::OnBeforeAuctionHouseMgrSendAuctionOutbiddedMail(
     bool&,                 /* sendNotification */
     bool&                  /* sendMail */)
 {
-    if (oldBidder && !newBidder)
+    AHBHookTimer timer(AHB_HOOK_OUTBID_MAIL);
+
+    //
+    // The bots have no player to pass as the new bidder; name the bot that outbid, and nobody
+    // when the mail does not come from a bot
+    //
+
+    if (oldBidder && !newBidder && gOutbidder)
     {
-        if (gBotsId.size() > 0)
-        {
-            //
-            // Use a random bot id
-            //
-
-            uint32 randBot = urand(0, gBotsId.size() - 1);
-            std::set<uint32>::iterator it = gBotsId.begin();
-            std::advance(it, randBot);
-
-            oldBidder->GetSession()->SendAuctionBidderNotification(
-                auction->GetHouseId(),
-                auction->Id,
-                ObjectGuid::Create<HighGuid::Player>(*it),
-                newPrice,
-                auction->GetAuctionOutBid(),
-                auction->item_template);
-        }
+        oldBidder->GetSession()->SendAuctionBidderNotification(
+            auction->GetHouseId(),
+            auction->Id,
+            ObjectGuid::Create<HighGuid::Player>(gOutbidder),
+            newPrice,
+            auction->GetAuctionOutBid(),
+            auction->item_template);
     }
 }
 
 void AHBot_AuctionHouseScript::OnAuctionAdd(AuctionHouseObject* /*ah*/, AuctionEntry* auction)
 {
+    AHBHookTimer timer(AHB_HOOK_AUCTION_ADD);
+
     // 
     // The the configuration for the auction house
     // 
@@ -99,6 +120,20 @@ void AHBot_AuctionHouseScript::OnAuctionAdd(AuctionHouseObject* /*ah*/, AuctionE
         }
     }
 
+    //
+    // Keeps the index of the bots auctions updated
+    //
+
+    if (gBotsId.find(auction->owner.GetCounter()) != gBotsId.end())
+    {
+        config->AddBotAuction(auction->owner.GetCounter(), auction->Id);
+    }
+
+    if (gRecorder.Running())
+    {
+        gRecorder.Record(AHB_RECORD_ADD, config->GetAHID(), auction->item_template, getRandomPropertyId(auction), auction->itemCount, auction->buyout);
+    }
+
     // 
     // Consider only those auctions handled by the bots
     // 
@@ -143,6 +178,8 @@ void AHBot_AuctionHouseScript::OnAuctionAdd(AuctionHouseObject* /*ah*/, AuctionE
 
 void AHBot_AuctionHouseScript::OnAuctionRemove(AuctionHouseObject* /*ah*/, AuctionEntry* auction)
 {
+    AHBHookTimer timer(AHB_HOOK_AUCTION_REMOVE);
+
     // 
     // Get the configuration for the auction house
     // 
@@ -162,6 +199,20 @@ void AHBot_AuctionHouseScript::OnAuctionRemove(AuctionHouseObject* /*ah*/, Aucti
         }
     }
 
+    //
+    // Keeps the index of the bots auctions updated
+    //
+
+    if (gBotsId.find(auction->owner.GetCounter()) != gBotsId.end())
+    {
+        config->RemoveBotAuction(auction->owner.GetCounter(), auction->Id);
+    }
+
+    if (gRecorder.Running())
+    {
+        gRecorder.Record(AHB_RECORD_REMOVE, config->GetAHID(), auction->item_template, getRandomPropertyId(auction), auction->itemCount, auction->buyout);
+    }
+
     // 
     // Consider only those auctions handled by the bots
     // 
@@ -206,6 +257,8 @@ void AHBot_AuctionHouseScript::OnAuctionRemove(AuctionHouseObject* /*ah*/, Aucti
 
 void AHBot_AuctionHouseScript::OnAuctionSuccessful(AuctionHouseObject* /*ah*/, AuctionEntry* auction)
 {
+    AHBHookTimer timer(AHB_HOOK_AUCTION_SUCCESSFUL);
+
     // 
     // Get the configuration for the auction house
     // 
@@ -230,11 +283,20 @@ void AHBot_AuctionHouseScript::OnAuctionSuccessful(AuctionHouseObject* /*ah*/, A
     // Use the buyout as a reference since the price for the bid is downgraded during selling.
     // 
 
-    config->UpdateItemStats(auction->item_template, auction->itemCount, auction->buyout);
+    int32 randomPropertyId = getRandomPropertyId(auction);
+
+    config->UpdateItemStats(auction->item_template, randomPropertyId, auction->itemCount, auction->buyout, gMarketRandom);
+
+    if (gRecorder.Running())
+    {
+        gRecorder.Record(AHB_RECORD_SUCCESSFUL, config->GetAHID(), auction->item_template, randomPropertyId, auction->itemCount, auction->buyout);
+    }
 }
 
 void AHBot_AuctionHouseScript::OnAuctionExpire(AuctionHouseObject* /*ah*/, AuctionEntry* auction)
 {
+    AHBHookTimer timer(AHB_HOOK_AUCTION_EXPIRE);
+
     // 
     // Get the configuration for the auction house
     // 
@@ -259,7 +321,14 @@ void AHBot_AuctionHouseScript::OnAuctionExpire(AuctionHouseObject* /*ah*/, Aucti
     // Bid price is usually less or equal to the buyout, so this likely will bring the price down.
     // 
 
-    config->UpdateItemStats(auction->item_template, auction->itemCount, auction->bid);
+    int32 randomPropertyId = getRandomPropertyId(auction);
+
+    config->UpdateItemStats(auction->item_template, randomPropertyId, auction->itemCount, auction->bid, gMarketRandom);
+
+    if (gRecorder.Running())
+    {
+        gRecorder.Record(AHB_RECORD_EXPIRE, config->GetAHID(), auction->item_template, randomPropertyId, auction->itemCount, auction->bid);
+    }
 }
 
 void AHBot_AuctionHouseScript::OnBeforeAuctionHouseMgrUpdate()
@@ -268,8 +337,12 @@ void AHBot_AuctionHouseScript::OnBeforeAuctionHouseMgrUpdate()
     // For every registered bot, perform an update
     //
 
+    gDbStats.BeginCycle();
+
     for (AuctionHouseBot* bot: gBots)
     {
         bot->Update();
     }
+
+    gDbStats.EndCycle();
 }
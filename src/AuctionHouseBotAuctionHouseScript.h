@@ -14,6 +14,9 @@
 
 class AHBot_AuctionHouseScript : public AuctionHouseScript
 {
+private:
+    int32 getRandomPropertyId(AuctionEntry* auction);
+
 public:
     AHBot_AuctionHouseScript();
 
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "AuctionHouseMgr.h"
+#include "GameTime.h"
+#include "Item.h"
+#include "Log.h"
+
+#include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotColumnar.h"
+#include "AuctionHouseBotConfig.h"
+
+//
+// Header of the file, changed whenever the layout changes
+//
+
+static char const columnarMagic[8] = { 'A', 'H', 'B', 'C', 'O', 'L', '0', '1' };
+
+//
+// Fixed size of the table and column names in the file
+//
+
+#define AHB_COLUMNAR_NAME 16
+
+AHBColumnarWriter::AHBColumnarWriter()
+{
+    _stop = false;
+}
+
+AHBColumnarWriter::~AHBColumnarWriter()
+{
+    Stop();
+}
+
+void AHBColumnarWriter::Start(std::string const& directory)
+{
+    Stop();
+
+    if (directory.empty())
+    {
+        return;
+    }
+
+    _directory = directory;
+    _stop      = false;
+    _pending.clear();
+    _thread    = std::thread(&AHBColumnarWriter::run, this);
+}
+
+void AHBColumnarWriter::Stop()
+{
+    if (!_thread.joinable())
+    {
+        return;
+    }
+
+    //
+    // The snapshots already taken are still written
+    //
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+
+    _wakeup.notify_one();
+    _thread.join();
+}
+
+void AHBColumnarWriter::run()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+
+    while (true)
+    {
+        _wakeup.wait(guard, [this] { return _stop || !_pending.empty(); });
+
+        while (!_pending.empty())
+        {
+            std::shared_ptr<AHBColumnarSnapshot const> snapshot = _pending.begin()->second;
+
+            _pending.erase(_pending.begin());
+
+            //
+            // Do not hold the lock during the I/O, the world thread may be submitting
+            //
+
+            guard.unlock();
+            write(*snapshot);
+            guard.lock();
+        }
+
+        if (_stop)
+        {
+            return;
+        }
+    }
+}
+
+void AHBColumnarWriter::write(AHBColumnarSnapshot const& snapshot)
+{
+    std::string path = _directory + "/ahbot_" + std::to_string(snapshot.house) + ".col";
+    std::string temp = path + ".tmp";
+
+    FILE* file = fopen(temp.c_str(), "wb");
+
+    if (!file)
+    {
+        LOG_ERROR("module", "AHBot: could not open the columnar file {}", temp);
+        return;
+    }
+
+    auto name = [file](std::string const& text)
+    {
+        char buffer[AHB_COLUMNAR_NAME] = { 0 };
+
+        strncpy(buffer, text.c_str(), AHB_COLUMNAR_NAME - 1);
+        fwrite(buffer, sizeof(buffer), 1, file);
+    };
+
+    auto integer = [file](uint64 value, uint8 width)
+    {
+        uint8 bytes[8];
+
+        for (uint8 i = 0; i < width; ++i)
+        {
+            bytes[i] = uint8(value >> (8 * i));
+        }
+
+        fwrite(bytes, width, 1, file);
+    };
+
+    fwrite(columnarMagic, sizeof(columnarMagic), 1, file);
+
+    integer(snapshot.house        , 4);
+    integer(snapshot.time         , 4);
+    integer(snapshot.tables.size(), 4);
+
+    for (AHBColumnarTable const& table : snapshot.tables)
+    {
+        uint32 rows = table.columns.empty() ? 0 : table.columns.front().values.size();
+
+        name   (table.name);
+        integer(rows                , 4);
+        integer(table.columns.size(), 4);
+
+        for (AHBColumn const& column : table.columns)
+        {
+            name   (column.name);
+            integer(column.width, 1);
+
+            //
+            // Encode the whole column at once, a write per value would be far slower
+            //
+
+            std::vector<uint8> data(rows * column.width);
+
+            for (uint32 row = 0; row < rows; ++row)
+            {
+                for (uint8 i = 0; i < column.width; ++i)
+                {
+                    data[row * column.width + i] = uint8(column.values[row] >> (8 * i));
+                }
+            }
+
+            fwrite(data.data(), 1, data.size(), file);
+        }
+    }
+
+    bool failed = ferror(file) != 0;
+
+    if (fclose(file) != 0 || failed)
+    {
+        LOG_ERROR("module", "AHBot: could not write the columnar file {}", temp);
+        return;
+    }
+
+    if (std::rename(temp.c_str(), path.c_str()) != 0)
+    {
+        LOG_ERROR("module", "AHBot: could not rename the columnar file {} to {}", temp, path);
+    }
+}
+
+void AHBColumnarWriter::Snapshot(AHBConfig* config)
+{
+    if (!Running())
+    {
+        return;
+    }
+
+    std::shared_ptr<AHBColumnarSnapshot> snapshot = std::make_shared<AHBColumnarSnapshot>();
+
+    snapshot->house = config->GetAHID();
+    snapshot->time  = uint32(GameTime::GetGameTime().count());
+
+    //
+    // Auctions currently listed
+    //
+
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAHFID());
+
+    if (auctionHouse)
+    {
+        AHBColumnarTable auctions("auctions");
+
+        auctions.columns.emplace_back("id"      , 4);
+        auctions.columns.emplace_back("item"    , 4);
+        auctions.columns.emplace_back("random"  , 4);
+        auctions.columns.emplace_back("count"   , 2);
+        auctions.columns.emplace_back("owner"   , 4);
+        auctions.columns.emplace_back("bot"     , 1);
+        auctions.columns.emplace_back("bidder"  , 4);
+        auctions.columns.emplace_back("startbid", 8);
+        auctions.columns.emplace_back("bid"     , 8);
+        auctions.columns.emplace_back("buyout"  , 8);
+        auctions.columns.emplace_back("expire"  , 4);
+
+        for (AHBColumn& column : auctions.columns)
+        {
+            column.values.reserve(auctionHouse->Getcount());
+        }
+
+        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
+        {
+            AuctionEntry* auction = itr->second;
+            Item*         item    = sAuctionMgr->GetAItem(auction->item_guid);
+
+            uint64 row[] =
+            {
+                auction->Id,
+                auction->item_template,
+                uint32(item ? item->GetItemRandomPropertyId() : 0),
+                auction->itemCount,
+                auction->owner.GetCounter(),
+                gBotsId.find(auction->owner.GetCounter()) != gBotsId.end() ? 1u : 0u,
+                auction->bidder.GetCounter(),
+                auction->startbid,
+                auction->bid,
+                auction->buyout,
+                uint64(auction->expire_time)
+            };
+
+            for (uint32 i = 0; i < auctions.columns.size(); ++i)
+            {
+                auctions.columns[i].values.push_back(row[i]);
+            }
+        }
+
+        snapshot->tables.push_back(std::move(auctions));
+    }
+
+    //
+    // Market statistics
+    //
+
+    std::vector<AHBItemStatsRow> rows;
+
+    config->GetItemStatsRows(rows);
+
+    AHBColumnarTable market("market");
+
+    market.columns.emplace_back("item"   , 4);
+    market.columns.emplace_back("random" , 4);
+    market.columns.emplace_back("samples", 4);
+    market.columns.emplace_back("total"  , 8);
+    market.columns.emplace_back("price"  , 8);
+    market.columns.emplace_back("p25"    , 4);
+    market.columns.emplace_back("p50"    , 4);
+    market.columns.emplace_back("p75"    , 4);
+
+    for (AHBColumn& column : market.columns)
+    {
+        column.values.reserve(rows.size());
+    }
+
+    for (AHBItemStatsRow const& stats : rows)
+    {
+        uint64 row[] = { stats.item, uint32(stats.random), stats.samples, stats.total, stats.price, stats.p25, stats.p50, stats.p75 };
+
+        for (uint32 i = 0; i < market.columns.size(); ++i)
+        {
+            market.columns[i].values.push_back(row[i]);
+        }
+    }
+
+    snapshot->tables.push_back(std::move(market));
+
+    //
+    // Hand over to the writer
+    //
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+
+        _pending[snapshot->house] = snapshot;
+    }
+
+    _wakeup.notify_one();
+}
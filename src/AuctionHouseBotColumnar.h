@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_COLUMNAR_H
+#define AUCTION_HOUSE_BOT_COLUMNAR_H
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common.h"
+
+class AHBConfig;
+
+// =============================================================================
+// Column of fixed width little endian integers, of 1, 2, 4 or 8 bytes
+// =============================================================================
+
+struct AHBColumn
+{
+    std::string         name;
+    uint8               width;
+    std::vector<uint64> values;
+
+    AHBColumn(std::string const& name, uint8 width) : name(name), width(width) { };
+};
+
+struct AHBColumnarTable
+{
+    std::string            name;
+    std::vector<AHBColumn> columns;
+
+    AHBColumnarTable(std::string const& name) : name(name) { };
+};
+
+//
+// Everything written for a house at a given time; never changed once handed over
+//
+
+struct AHBColumnarSnapshot
+{
+    uint32                        house;
+    uint32                        time;
+    std::vector<AHBColumnarTable> tables;
+};
+
+// =============================================================================
+// Columnar export of the auctions and of the market statistics of the houses,
+// for offline analysis without querying the live auctionhouse table.
+//
+// The world thread copies the data into an immutable snapshot and hands it to
+// a dedicated thread, which writes one file per house, ahbot_<house>.col,
+// through a temporary file renamed over the target. A snapshot not yet written
+// is replaced by a newer one of the same house.
+//
+// Layout, all integers little endian:
+//   "AHBCOL01", uint32 house, uint32 game time, uint32 tables
+//   per table:  char name[16], uint32 rows, uint32 columns
+//     per column: char name[16], uint8 width, then rows * width bytes
+// =============================================================================
+
+class AHBColumnarWriter
+{
+private:
+    std::string             _directory;
+
+    std::thread             _thread;
+    std::mutex              _lock;
+    std::condition_variable _wakeup;
+    bool                    _stop;
+
+    std::map<uint32, std::shared_ptr<AHBColumnarSnapshot const>> _pending;
+
+    void run  ();
+    void write(AHBColumnarSnapshot const& snapshot);
+
+public:
+    AHBColumnarWriter();
+    ~AHBColumnarWriter();
+
+    void Start  (std::string const& directory);
+    void Stop   ();
+    bool Running() const { return _thread.joinable(); };
+
+    void Snapshot(AHBConfig* config);
+};
+
+extern AHBColumnarWriter gColumnar;
+
+#endif // AUCTION_HOUSE_BOT_COLUMNAR_H
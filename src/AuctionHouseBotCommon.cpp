@@ -3,8 +3,17 @@
  */
 
 #include "AuctionHouseBot.h"
+#include "AuctionHouseBotColumnar.h"
 #include "AuctionHouseBotCommon.h"
 #include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotJob.h"
+#include "AuctionHouseBotLoad.h"
+#include "AuctionHouseBotPopulation.h"
+#include "AuctionHouseBotRandom.h"
+#include "AuctionHouseBotRecorder.h"
+#include "AuctionHouseBotStats.h"
+#include "AuctionHouseBotSweeper.h"
+#include "AuctionHouseBotTracer.h"
 
 // 
 // Configuration used globally by all the bots instances
@@ -20,3 +29,64 @@ AHBConfig* gNeutralConfig  = new AHBConfig(7);
 
 std::set<uint32>           gBotsId;
 std::set<AuctionHouseBot*> gBots;
+uint32                     gOutbidder = 0;
+
+// 
+// Trace records of all the bots
+// 
+
+AHBTracer gTracer;
+
+// 
+// Auction event stream recording
+// 
+
+AHBRecorder gRecorder;
+
+// 
+// Database calls of the whole module
+// 
+
+AHBDbStats gDbStats;
+
+// 
+// Calls and latencies of the hooks
+// 
+
+AHBHookStats gHookStats;
+
+// 
+// Synthetic load test
+// 
+
+AHBLoadGenerator gLoadGenerator;
+
+// 
+// Columnar export of the houses
+// 
+
+AHBColumnarWriter gColumnar;
+
+// 
+// Garbage collection of the item rows of the bots
+// 
+
+AHBItemSweeper gSweeper;
+
+// 
+// Online population driving the quotas of the houses
+// 
+
+AHBPopulation gPopulation;
+
+// 
+// Random stream of the market statistics of the live houses
+// 
+
+AHBRandom gMarketRandom;
+
+// 
+// Offline tools, run off the world thread
+// 
+
+AHBJob gJob;
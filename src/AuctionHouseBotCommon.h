@@ -101,5 +101,6 @@ enum class AHBotCommand : uint32
 
 extern std::set<uint32>           gBotsId; // Active bots players ids
 extern std::set<AuctionHouseBot*> gBots;   // Active bots
+extern uint32                     gOutbidder; // Bot sending an outbid mail, 0 outside of it
 
 #endif // AUCTION_HOUSE_BOT_COMMON_H
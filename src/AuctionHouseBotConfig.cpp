@@ -21,15 +21,21 @@
 #include "Common.h"
 #include "Config.h"
 #include "DatabaseEnv.h"
+#include "GameTime.h"
 #include "Item.h"
 #include "ItemTemplate.h"
 #include "Log.h"
 #include "ObjectMgr.h"
 #include "QueryResult.h"
+#include "StringFormat.h"
+#include "Util.h"
 #include "WorldSession.h"
 
 #include "AuctionHouseBotCommon.h"
 #include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotMemory.h"
+#include "AuctionHouseBotPopulation.h"
+#include "AuctionHouseBotRandom.h"
 
 using namespace std;
 
@@ -118,6 +124,7 @@ AHBConfig::AHBConfig(uint32 ahid, AHBConfig* conf)
     minBidPriceGrey                = conf->minBidPriceGrey;
     maxBidPriceGrey                = conf->maxBidPriceGrey;
     maxStackGrey                   = conf->maxStackGrey;
+    minPriceWhite                  = conf->minPriceWhite;
     maxPriceWhite                  = conf->maxPriceWhite;
     minBidPriceWhite               = conf->minBidPriceWhite;
     maxBidPriceWhite               = conf->maxBidPriceWhite;
@@ -203,6 +210,39 @@ AHBConfig::AHBConfig(uint32 ahid, AHBConfig* conf)
     AHBBuyer                       = conf->AHBBuyer;
     BuyMethod                      = conf->BuyMethod;
     SellMethod                     = conf->SellMethod;
+    SellAtMarketPrice              = conf->SellAtMarketPrice;
+    MarketResetThreshold           = conf->MarketResetThreshold;
+    MarketPersistence              = conf->MarketPersistence;
+    MarketFlushInterval            = conf->MarketFlushInterval;
+    MarketFlushBatch               = conf->MarketFlushBatch;
+    MarketSellQuantileMin          = conf->MarketSellQuantileMin;
+    MarketSellQuantileMax          = conf->MarketSellQuantileMax;
+    MarketBuyQuantile              = conf->MarketBuyQuantile;
+    MarketMergeHouses              = conf->MarketMergeHouses;
+    MarketVariantMinSamples        = conf->MarketVariantMinSamples;
+    MetricsFile                    = conf->MetricsFile;
+    MetricsInterval                = conf->MetricsInterval;
+    RecordFile                     = conf->RecordFile;
+    HookTimings                    = conf->HookTimings;
+    LoadTestAccount                = conf->LoadTestAccount;
+    LoadTestGUID                   = conf->LoadTestGUID;
+    LoadTestBidderGUID             = conf->LoadTestBidderGUID;
+    ColumnarDirectory              = conf->ColumnarDirectory;
+    ColumnarInterval               = conf->ColumnarInterval;
+    RandomSeed                     = conf->RandomSeed;
+    PricingStrategy                = conf->PricingStrategy;
+    Checkpoint                     = conf->Checkpoint;
+    SweepInterval                  = conf->SweepInterval;
+    SweepRange                     = conf->SweepRange;
+    BundleWeights                  = conf->BundleWeights;
+    SharedSellPlan                 = conf->SharedSellPlan;
+    SharedSellSource               = NULL;
+    SharedSellPerturbation         = conf->SharedSellPerturbation;
+    PopulationScaling              = conf->PopulationScaling;
+    PopulationFull                 = conf->PopulationFull;
+    PopulationFloor                = conf->PopulationFloor;
+    PopulationCeiling              = conf->PopulationCeiling;
+    PopulationSmoothing            = conf->PopulationSmoothing;
     ConsiderOnlyBotAuctions        = conf->ConsiderOnlyBotAuctions;
     ItemsPerCycle                  = conf->ItemsPerCycle;
     Vendor_Items                   = conf->Vendor_Items;
@@ -372,6 +412,17 @@ AHBConfig::AHBConfig(uint32 ahid, AHBConfig* conf)
     {
         YellowItemsBin.insert(id);
     }
+
+    //
+    // Every pricing input is copied by now, the copy must price like its source
+    //
+
+    InitializePricing();
+
+    if (conf->pricing && std::string(pricing->GetName()) != conf->pricing->GetName())
+    {
+        LOG_ERROR("module", "AHBot: the copy of the house {} prices with {} instead of {}", conf->AHID, pricing->GetName(), conf->pricing->GetName());
+    }
 }
 
 AHBConfig::~AHBConfig()
@@ -510,6 +561,38 @@ void AHBConfig::Reset()
     BuyMethod                      = false;
     SellMethod                     = false;
     SellAtMarketPrice              = false;
+    MarketResetThreshold           = 25;
+    MarketPersistence              = true;
+    MarketFlushInterval            = 60;
+    MarketFlushBatch               = 100;
+    MarketSellQuantileMin          = 40;
+    MarketSellQuantileMax          = 60;
+    MarketBuyQuantile              = 0;
+    MarketMergeHouses              = false;
+    MarketVariantMinSamples        = 5;
+    MetricsFile                    = "";
+    MetricsInterval                = 15;
+    RecordFile                     = "";
+    HookTimings                    = false;
+    LoadTestAccount                = 0;
+    LoadTestGUID                   = 0;
+    LoadTestBidderGUID             = 0;
+    ColumnarDirectory              = "";
+    ColumnarInterval               = 300;
+    RandomSeed                     = 0;
+    PricingStrategy                = 0;
+    Checkpoint                     = true;
+    SweepInterval                  = 0;
+    SweepRange                     = 10000;
+    BundleWeights.clear();
+    SharedSellPlan                 = false;
+    SharedSellSource               = NULL;
+    SharedSellPerturbation         = 10;
+    PopulationScaling              = false;
+    PopulationFull                 = 500;
+    PopulationFloor                = 25;
+    PopulationCeiling              = 100;
+    PopulationSmoothing            = 20;
     ConsiderOnlyBotAuctions        = false;
     ItemsPerCycle                  = 200;
 
@@ -594,9 +677,15 @@ void AHBConfig::Reset()
     OrangeItemsBin.clear();
     YellowItemsBin.clear();
 
-    itemsCount.clear();
-    itemsSum.clear();
-    itemsPrice.clear();
+    itemsStats.Clear();
+    itemsDirty.clear();
+
+    botsAuctions.clear();
+
+    checkpointEpoch                = 0;
+    checkpointRuns.clear();
+
+    InitializePricing();
 }
 
 uint32 AHBConfig::GetAHID()
@@ -609,6 +698,111 @@ uint32 AHBConfig::GetAHFID()
     return AHFID;
 }
 
+AHBPricing* AHBConfig::GetPricing()
+{
+    return pricing.get();
+}
+
+void AHBConfig::InitializePricing()
+{
+    pricing.reset(AHBCreatePricing(this));
+
+    if (DebugOutConfig)
+    {
+        LOG_INFO("module", "AHBot: pricing strategy of the house {} is {}", AHID, pricing->GetName());
+    }
+}
+
+bool AHBConfig::IsMirrorOf(AHBConfig* other)
+{
+    //
+    // Same quotas, before the population scaling that applies to every house alike...
+    //
+
+    if (minItems  != other->minItems  || maxItems  != other->maxItems  ||
+        greytgp   != other->greytgp   || greyip    != other->greyip    ||
+        whitetgp  != other->whitetgp  || whiteip   != other->whiteip   ||
+        greentgp  != other->greentgp  || greenip   != other->greenip   ||
+        bluetgp   != other->bluetgp   || blueip    != other->blueip    ||
+        purpletgp != other->purpletgp || purpleip  != other->purpleip  ||
+        orangetgp != other->orangetgp || orangeip  != other->orangeip  ||
+        yellowtgp != other->yellowtgp || yellowip  != other->yellowip)
+    {
+        return false;
+    }
+
+    //
+    // ...same price ranges and stacks...
+    //
+
+    for (uint32 color = AHB_GREY; color <= AHB_YELLOW; ++color)
+    {
+        if (GetMinPrice   (color) != other->GetMinPrice   (color) ||
+            GetMaxPrice   (color) != other->GetMaxPrice   (color) ||
+            GetMinBidPrice(color) != other->GetMinBidPrice(color) ||
+            GetMaxBidPrice(color) != other->GetMaxBidPrice(color) ||
+            GetMaxStack   (color) != other->GetMaxStack   (color))
+        {
+            return false;
+        }
+    }
+
+    //
+    // ...same pricing, on prices that do not depend on the house...
+    //
+
+    if (std::string(pricing->GetName()) != other->pricing->GetName())
+    {
+        return false;
+    }
+
+    if (pricing->IsMarketSell() && !MarketMergeHouses)
+    {
+        return false;
+    }
+
+    //
+    // ...and the same candidates
+    //
+
+    return GreyTradeGoodsBin   == other->GreyTradeGoodsBin   && GreyItemsBin   == other->GreyItemsBin   &&
+           WhiteTradeGoodsBin  == other->WhiteTradeGoodsBin  && WhiteItemsBin  == other->WhiteItemsBin  &&
+           GreenTradeGoodsBin  == other->GreenTradeGoodsBin  && GreenItemsBin  == other->GreenItemsBin  &&
+           BlueTradeGoodsBin   == other->BlueTradeGoodsBin   && BlueItemsBin   == other->BlueItemsBin   &&
+           PurpleTradeGoodsBin == other->PurpleTradeGoodsBin && PurpleItemsBin == other->PurpleItemsBin &&
+           OrangeTradeGoodsBin == other->OrangeTradeGoodsBin && OrangeItemsBin == other->OrangeItemsBin &&
+           YellowTradeGoodsBin == other->YellowTradeGoodsBin && YellowItemsBin == other->YellowItemsBin;
+}
+
+void AHBUpdateMirrors()
+{
+    //
+    // Done whenever the settings change rather than on every selling cycle. The houses sell
+    // in this order, a house replays the plan of the first one before it with the same settings.
+    //
+
+    AHBConfig* houses[] = { gAllianceConfig, gHordeConfig, gNeutralConfig };
+
+    for (uint32 house = 0; house < std::size(houses); ++house)
+    {
+        houses[house]->SharedSellSource = NULL;
+
+        if (!houses[house]->SharedSellPlan)
+        {
+            continue;
+        }
+
+        for (uint32 source = 0; source < house; ++source)
+        {
+            if (houses[source]->SharedSellPlan && houses[house]->IsMirrorOf(houses[source]))
+            {
+                houses[house]->SharedSellSource = houses[source];
+                break;
+            }
+        }
+    }
+}
+
 void AHBConfig::SetMinItems(uint32 value)
 {
     minItems = value;
@@ -618,15 +812,15 @@ uint32 AHBConfig::GetMinItems()
 {
     if ((minItems == 0) && (maxItems))
     {
-        return maxItems;
+        return scaleByPopulation(maxItems);
     }
     else if ((maxItems) && (minItems > maxItems))
     {
-        return maxItems;
+        return scaleByPopulation(maxItems);
     }
     else
     {
-        return minItems;
+        return scaleByPopulation(minItems);
     }
 }
 
@@ -639,7 +833,22 @@ void AHBConfig::SetMaxItems(uint32 value)
 
 uint32 AHBConfig::GetMaxItems()
 {
-    return maxItems;
+    return scaleByPopulation(maxItems);
+}
+
+uint32 AHBConfig::scaleByPopulation(uint32 value)
+{
+    //
+    // Quotas follow the online population when AuctionHouseBot.PopulationScaling is set;
+    // the scratch copies of the tools clear it to keep their quotas reproducible
+    //
+
+    if (!PopulationScaling)
+    {
+        return value;
+    }
+
+    return uint32(uint64(value) * gPopulation.GetScale() / 100);
 }
 
 void AHBConfig::SetPercentages(
@@ -1618,58 +1827,58 @@ uint32 AHBConfig::GetMaximum(uint32 color)
     switch (color)
     {
     case AHB_GREY_TG:
-        return greytgp;
+        return scaleByPopulation(greytgp);
         break;
 
     case AHB_WHITE_TG:
-        return whitetgp;
+        return scaleByPopulation(whitetgp);
         break;
 
     case AHB_GREEN_TG:
-        return greentgp;
+        return scaleByPopulation(greentgp);
         break;
 
     case AHB_BLUE_TG:
-        return bluetgp;
+        return scaleByPopulation(bluetgp);
         break;
 
     case AHB_PURPLE_TG:
-        return purpletgp;
+        return scaleByPopulation(purpletgp);
         break;
     case AHB_ORANGE_TG:
-        return orangetgp;
+        return scaleByPopulation(orangetgp);
         break;
 
     case AHB_YELLOW_TG:
-        return yellowtgp;
+        return scaleByPopulation(yellowtgp);
         break;
 
     case AHB_GREY_I:
-        return greyip;
+        return scaleByPopulation(greyip);
         break;
 
     case AHB_WHITE_I:
-        return whiteip;
+        return scaleByPopulation(whiteip);
         break;
 
     case AHB_GREEN_I:
-        return greenip;
+        return scaleByPopulation(greenip);
         break;
 
     case AHB_BLUE_I:
-        return blueip;
+        return scaleByPopulation(blueip);
         break;
 
     case AHB_PURPLE_I:
-        return purpleip;
+        return scaleByPopulation(purpleip);
         break;
 
     case AHB_ORANGE_I:
-        return orangeip;
+        return scaleByPopulation(orangeip);
         break;
 
     case AHB_YELLOW_I:
-        return yellowip;
+        return scaleByPopulation(yellowip);
         break;
 
     default:
@@ -1855,6 +2064,71 @@ void AHBConfig::ResetItemCounts()
     yellowItems  = 0;
 }
 
+void AHBConfig::SetItemCounts(uint32 color, uint32 value)
+{
+    switch (color)
+    {
+    case AHB_GREY_TG:
+        greyTGoods = value;
+        break;
+
+    case AHB_WHITE_TG:
+        whiteTGoods = value;
+        break;
+
+    case AHB_GREEN_TG:
+        greenTGoods = value;
+        break;
+
+    case AHB_BLUE_TG:
+        blueTGoods = value;
+        break;
+
+    case AHB_PURPLE_TG:
+        purpleTGoods = value;
+        break;
+
+    case AHB_ORANGE_TG:
+        orangeTGoods = value;
+        break;
+
+    case AHB_YELLOW_TG:
+        yellowTGoods = value;
+        break;
+
+    case AHB_GREY_I:
+        greyItems = value;
+        break;
+
+    case AHB_WHITE_I:
+        whiteItems = value;
+        break;
+
+    case AHB_GREEN_I:
+        greenItems = value;
+        break;
+
+    case AHB_BLUE_I:
+        blueItems = value;
+        break;
+
+    case AHB_PURPLE_I:
+        purpleItems = value;
+        break;
+
+    case AHB_ORANGE_I:
+        orangeItems = value;
+        break;
+
+    case AHB_YELLOW_I:
+        yellowItems = value;
+        break;
+
+    default:
+        break;
+    }
+}
+
 uint32 AHBConfig::TotalItemCounts()
 {
     return(
@@ -1951,7 +2225,7 @@ uint32 AHBConfig::GetBidsPerInterval()
     return buyerBidsPerInterval;
 }
 
-void AHBConfig::UpdateItemStats(uint32 id, uint32 stackSize, uint64 buyout)
+void AHBConfig::UpdateItemStats(uint32 id, int32 randomPropertyId, uint32 stackSize, uint64 buyout, AHBRandom& random)
 {
     if (!stackSize)
     {
@@ -1959,31 +2233,64 @@ void AHBConfig::UpdateItemStats(uint32 id, uint32 stackSize, uint64 buyout)
     }
 
     // 
-    // Collects information about the item bought
+    // Collects information about the item bought, both for the variant and for the whole template
     //
 
     uint32 perUnit = buyout / stackSize;
 
-    if (itemsCount.count(id) == 0)
+    updateItemStats(ItemStatsKey(id, randomPropertyId), perUnit, random);
+
+    if (randomPropertyId != 0)
     {
-        itemsCount[id] = 1;
-        itemsSum[id]   = perUnit;
-        itemsPrice[id] = perUnit;
+        updateItemStats(ItemStatsKey(id, 0), perUnit, random);
+    }
+
+    if (DebugOutConfig)
+    {
+        LOG_INFO("module", "Updating market price item={}, random={}, price={}", id, randomPropertyId, GetItemPrice(id, randomPropertyId));
+    }
+}
+
+void AHBConfig::updateItemStats(uint64 key, uint32 perUnit, AHBRandom& random)
+{
+    ItemStats& stats = itemsStats[key];
+
+    //
+    // The quantile sketch ignores the expired auctions that never received a bid
+    //
+
+    if (perUnit)
+    {
+        stats.sketch.Add(perUnit);
+    }
+
+    if (stats.count == 0)
+    {
+        stats.count = 1;
+        stats.sum   = perUnit;
+        stats.price = perUnit;
     }
     else
     {
-        itemsCount[id]++;
+        stats.count++;
 
         //
         // Reset the statistics to force adapt to the market price.
-        // Adds a little of randomness by adding/removing a range of 9 to the threshold.
+        // Adds a little of randomness by adding/removing a range of 9 to the threshold,
+        // drawn from the caller's stream so that a seeded replay learns the same prices.
         //
 
-        if (itemsCount[id] > MarketResetThreshold + (urand(1, 19) - 10))
+        if (stats.count > MarketResetThreshold + (random.Range(1, 19) - 10))
         {
-            itemsCount[id] = 1;
-            itemsSum[id]   = perUnit;
-            itemsPrice[id] = perUnit;
+            stats.count = 1;
+            stats.sum   = perUnit;
+            stats.price = perUnit;
+
+            //
+            // The sketch is not thrown away: the older samples just weight less
+            //
+
+            stats.sketch.Decay();
         }
         else
         {
@@ -1992,125 +2299,932 @@ void AHBConfig::UpdateItemStats(uint32 id, uint32 stackSize, uint64 buyout)
             // right now is a plain, boring average of the ~100 previous auctions.
             //
 
-            itemsSum[id]   = (itemsSum[id] + perUnit);
-            itemsPrice[id] = itemsSum[id] / itemsCount[id];
+            stats.sum   = (stats.sum + perUnit);
+            stats.price = stats.sum / stats.count;
         }
     }
 
-    if (DebugOutConfig)
+    itemsDirty.insert(key);
+}
+
+AHBConfig::ItemStats const* AHBConfig::findItemStats(uint32 id, int32 randomPropertyId) const
+{
+    //
+    // A variant with too few samples is not reliable: use the aggregate of the template instead.
+    // The sketch keeps its weight across the resets of the average, unlike the count.
+    //
+
+    uint32 minSamples = MarketVariantMinSamples;
+
+    return itemsStats.Find(ItemStatsKey(id, randomPropertyId), ItemStatsKey(id, 0), [minSamples](ItemStats const& stats)
     {
-        LOG_INFO("module", "Updating market price item={}, price={}", id, itemsPrice[id]);
-    }
+        return stats.sketch.Total() >= minSamples;
+    });
 }
 
-uint64 AHBConfig::GetItemPrice(uint32 id)
+uint64 AHBConfig::GetItemPrice(uint32 id, int32 randomPropertyId)
 {
-    if (itemsCount.count(id) != 0)
+    ItemStats const* stats = findItemStats(id, randomPropertyId);
+
+    if (stats)
     {
-        return itemsPrice[id];
+        return stats->price;
     }
 
     return 0;
 }
 
-void AHBConfig::Initialize(std::set<uint32> botsIds)
-{
-    InitializeFromFile();
-    InitializeFromSql(botsIds);
-    InitializeBins();
-}
-
-void AHBConfig::InitializeFromFile()
+uint64 AHBConfig::GetItemQuantile(uint32 id, int32 randomPropertyId, uint32 percent)
 {
     //
-    // Load from, the configuration file
+    // Combine the samples of all the auction houses if requested
     //
 
-    DebugOut                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG"        , false);
-    DebugOutConfig                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_CONFIG" , false);
-    DebugOutFilters                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_FILTERS", false);
-    DebugOutBuyer                  = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_BUYER"  , false);
-    DebugOutSeller                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_SELLER" , false);
+    if (MarketMergeHouses)
+    {
+        AHBQuantileSketch merged;
 
-    TraceSeller                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.TRACE_SELLER" , false);
-    TraceBuyer                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.TRACE_BUYER"  , false);
+        for (AHBConfig* config : { gAllianceConfig, gHordeConfig, gNeutralConfig })
+        {
+            ItemStats const* stats = config->findItemStats(id, randomPropertyId);
 
-    AHBSeller                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.EnableSeller"           , false);
-    AHBBuyer                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.EnableBuyer"            , false);
-    SellMethod                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseBuyPriceForSeller"   , false);
-    BuyMethod                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseBuyPriceForBuyer"    , false);
-    SellAtMarketPrice              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseMarketPriceForSeller", false);
-    MarketResetThreshold           = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketResetThreshold"   , 25);
-    DuplicatesCount                = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DuplicatesCount"        , 0);
-    DivisibleStacks                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DivisibleStacks"        , false);
-    ElapsingTimeClass              = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DuplicatesCount"        , 1);
-    ConsiderOnlyBotAuctions        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.ConsiderOnlyBotAuctions", false);
-    ItemsPerCycle                  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ItemsPerCycle"          , 200);
+            if (stats)
+            {
+                merged.Merge(stats->sketch);
+            }
+        }
 
-    //
-    // Flags: item types
-    //
+        if (!merged.Empty())
+        {
+            return merged.Quantile(percent);
+        }
+    }
+    else
+    {
+        ItemStats const* stats = findItemStats(id, randomPropertyId);
 
-    Vendor_Items                   = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.VendorItems"      , false);
-    Loot_Items                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.LootItems"        , true);
-    Other_Items                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.OtherItems"       , false);
-    Vendor_TGs                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.VendorTradeGoods" , false);
-    Loot_TGs                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.LootTradeGoods"   , true);
-    Other_TGs                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.OtherTradeGoods"  , false);
+        if (stats && !stats->sketch.Empty())
+        {
+            return stats->sketch.Quantile(percent);
+        }
+    }
 
     //
-    // Flags: items binding
+    // No distribution known (yet): rely on the plain average
     //
 
-    No_Bind                        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.No_Bind"             , true);
-    Bind_When_Picked_Up            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Picked_Up" , false);
-    Bind_When_Equipped             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Equipped"  , true);
-    Bind_When_Use                  = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Use"       , true);
-    Bind_Quest_Item                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_Quest_Item"     , false);
+    return GetItemPrice(id, randomPropertyId);
+}
+
+void AHBConfig::LoadItemStats(uint32 id, int32 randomPropertyId, uint32 count, uint64 sum, std::vector<uint8> const& sketch)
+{
+    if (!count)
+    {
+        return;
+    }
 
     //
-    // Flags: misc
+    // Restores the statistics persisted during a previous run; they are not dirty
     //
 
-    DisableConjured                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableConjured"               , false);
-    DisableGems                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableGems"                   , false);
-    DisableMoney                   = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMoney"                  , false);
-    DisableMoneyLoot               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMoneyLoot"              , false);
-    DisableLootable                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableLootable"               , false);
-    DisableKeys                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableKeys"                   , false);
-    DisableDuration                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDuration"               , false);
-    DisableBOP_Or_Quest_NoReqLevel = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableBOP_Or_Quest_NoReqLevel", false);
+    ItemStats& stats = itemsStats[ItemStatsKey(id, randomPropertyId)];
 
-    //
-    // Flags: items per class
-    //
+    stats.count = count;
+    stats.sum   = sum;
+    stats.price = sum / count;
 
-    DisableWarriorItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableWarriorItems"    , false);
-    DisablePaladinItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisablePaladinItems"    , false);
-    DisableHunterItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableHunterItems"     , false);
-    DisableRogueItems              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableRogueItems"      , false);
-    DisablePriestItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisablePriestItems"     , false);
-    DisableDKItems                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDKItems"         , false);
-    DisableShamanItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableShamanItems"     , false);
-    DisableMageItems               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMageItems"       , false);
-    DisableWarlockItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableWarlockItems"    , false);
-    DisableUnusedClassItems        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableUnusedClassItems", false);
-    DisableDruidItems              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDruidItems"      , false);
+    if (!sketch.empty())
+    {
+        stats.sketch.Deserialize(sketch);
+    }
+}
 
+std::string AHBConfig::itemStatsStatement(uint32 maxItems, uint32& saved)
+{
     //
-    // Items level and skills
+    // One multi-row statement with up to maxItems dirty entries (all of them if zero)
     //
 
-    DisableItemsBelowLevel         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowLevel"       , 0);
-    DisableItemsAboveLevel         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveLevel"       , 0);
-    DisableItemsBelowGUID          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowGUID"        , 0);
-    DisableItemsAboveGUID          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveGUID"        , 0);
-    DisableItemsBelowReqLevel      = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqLevel"    , 0);
-    DisableItemsAboveReqLevel      = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqLevel"    , 0);
-    DisableItemsBelowReqSkillRank  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqSkillRank", 0);
-    DisableItemsAboveReqSkillRank  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqSkillRank", 0);
+    std::string values;
+    uint32      rows = 0;
 
-    //
+    std::set<uint64>::iterator it = itemsDirty.begin();
+
+    while (it != itemsDirty.end() && (maxItems == 0 || rows < maxItems))
+    {
+        uint64           key   = *it;
+        ItemStats const& stats = itemsStats[key];
+
+        if (rows > 0)
+        {
+            values += ",";
+        }
+
+        std::string sketch = "''";
+
+        if (!stats.sketch.Empty())
+        {
+            std::vector<uint8> data = stats.sketch.Serialize();
+            sketch                  = "0x" + ByteArrayToHexStr(data.data(), data.size());
+        }
+
+        values += Acore::StringFormat("({},{},{},{},{},{},{})", AHID, uint32(key >> 32), int32(uint32(key)), stats.count, stats.sum, stats.price, sketch);
+
+        it = itemsDirty.erase(it);
+        rows++;
+    }
+
+    saved += rows;
+
+    return "REPLACE INTO mod_auctionhousebot_market (auctionhouse, item, random, samples, total, price, sketch) VALUES " + values;
+}
+
+uint32 AHBConfig::SaveItemStats(uint32 maxItems, bool all)
+{
+    if (itemsDirty.empty())
+    {
+        return 0;
+    }
+
+    uint32 saved = 0;
+
+    if (all)
+    {
+        //
+        // Everything, still in statements of maxItems rows so none of them outgrows
+        // max_allowed_packet, committed together before the database goes away
+        //
+
+        WorldDatabaseTransaction trans = WorldDatabase.BeginTransaction();
+
+        while (!itemsDirty.empty())
+        {
+            trans->Append(itemStatsStatement(std::max<uint32>(maxItems, 1), saved).c_str());
+            gDbStats.Count(AHB_DB_MARKET_SAVE, AHB_DB_APPEND);
+        }
+
+        WorldDatabase.DirectCommitTransaction(trans);
+        gDbStats.Count(AHB_DB_MARKET_SAVE, AHB_DB_COMMIT);
+    }
+    else
+    {
+        WorldDatabase.Execute(itemStatsStatement(maxItems, saved));
+        gDbStats.Count(AHB_DB_MARKET_SAVE, AHB_DB_ASYNC);
+    }
+
+    if (DebugOutConfig)
+    {
+        LOG_INFO("module", "AHBot: saved {} market prices for auctionhouse {}, {} left", saved, AHID, uint32(itemsDirty.size()));
+    }
+
+    return saved;
+}
+
+uint32 AHBConfig::GetDirtyItemStats()
+{
+    return itemsDirty.size();
+}
+
+uint32 AHBConfig::GetItemStatsCount()
+{
+    return itemsStats.Size();
+}
+
+void AHBConfig::GetItemStatsRows(std::vector<AHBItemStatsRow>& rows)
+{
+    rows.reserve(rows.size() + itemsStats.Size());
+
+    for (uint32 index = 0; index < itemsStats.Size(); ++index)
+    {
+        uint64           key   = itemsStats.Key(index);
+        ItemStats const& stats = itemsStats.Value(index);
+        AHBItemStatsRow  row;
+
+        row.item    = uint32(key >> 32);
+        row.random  = int32(uint32(key));
+        row.samples = stats.count;
+        row.total   = stats.sum;
+        row.price   = stats.price;
+        row.p25     = stats.sketch.Quantile(25);
+        row.p50     = stats.sketch.Quantile(50);
+        row.p75     = stats.sketch.Quantile(75);
+
+        rows.push_back(row);
+    }
+}
+
+uint64 AHBConfig::ReportMemory(std::vector<std::string>& lines)
+{
+    uint64 total = 0;
+
+    auto line = [&lines, &total](char const* name, uint64 elements, uint64 bytes)
+    {
+        lines.push_back(Acore::StringFormat("  {:<20} {:>8} entries {:>10} bytes", name, elements, bytes));
+        total += bytes;
+    };
+
+    //
+    // Catalog, loaded for every house even when identical
+    //
+
+    line("NpcItems"        , NpcItems.size()        , AHBMemory(NpcItems));
+    line("LootItems"       , LootItems.size()       , AHBMemory(LootItems));
+    line("DisableItemStore", DisableItemStore.size(), AHBMemory(DisableItemStore));
+    line("SellerWhiteList" , SellerWhiteList.size() , AHBMemory(SellerWhiteList));
+
+    //
+    // Bins
+    //
+
+    std::pair<char const*, std::set<uint32> const*> bins[] =
+    {
+        { "GreyTradeGoodsBin"  , &GreyTradeGoodsBin   }, { "WhiteTradeGoodsBin" , &WhiteTradeGoodsBin  },
+        { "GreenTradeGoodsBin" , &GreenTradeGoodsBin  }, { "BlueTradeGoodsBin"  , &BlueTradeGoodsBin   },
+        { "PurpleTradeGoodsBin", &PurpleTradeGoodsBin }, { "OrangeTradeGoodsBin", &OrangeTradeGoodsBin },
+        { "YellowTradeGoodsBin", &YellowTradeGoodsBin },
+        { "GreyItemsBin"       , &GreyItemsBin        }, { "WhiteItemsBin"      , &WhiteItemsBin       },
+        { "GreenItemsBin"      , &GreenItemsBin       }, { "BlueItemsBin"       , &BlueItemsBin        },
+        { "PurpleItemsBin"     , &PurpleItemsBin      }, { "OrangeItemsBin"     , &OrangeItemsBin      },
+        { "YellowItemsBin"     , &YellowItemsBin      }
+    };
+
+    for (auto const& bin : bins)
+    {
+        line(bin.first, bin.second->size(), AHBMemory(*bin.second));
+    }
+
+    //
+    // Market statistics, the sketches are held in place
+    //
+
+    line("itemsStats", itemsStats.Size(), AHBMemory(itemsStats));
+    line("itemsDirty", itemsDirty.size(), AHBMemory(itemsDirty));
+
+    //
+    // Index of the bots auctions
+    //
+
+    uint64 auctions = 0;
+    uint64 bytes    = AHBMemory(botsAuctions);
+
+    for (auto const& bot : botsAuctions)
+    {
+        auctions += bot.second.size();
+        bytes    += AHBMemory(bot.second);
+    }
+
+    line("botsAuctions", auctions, bytes);
+
+    //
+    // The configuration itself, with the timings windows
+    //
+
+    line("AHBConfig", 1, sizeof(AHBConfig));
+
+    return total;
+}
+
+void AHBConfig::AddBotAuction(uint32 botId, uint32 auctionId)
+{
+    botsAuctions[botId].insert(auctionId);
+}
+
+void AHBConfig::RemoveBotAuction(uint32 botId, uint32 auctionId)
+{
+    std::map<uint32, std::set<uint32>>::iterator it = botsAuctions.find(botId);
+
+    if (it != botsAuctions.end())
+    {
+        it->second.erase(auctionId);
+    }
+}
+
+uint32 AHBConfig::ExpireBotAuctions(uint32 window)
+{
+    //
+    // Expire all the bots auctions in this house. When a window (in seconds) is given,
+    // the expirations are spread over it, so they are not all processed in the same tick.
+    //
+
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(GetAHFID());
+    time_t              now          = GameTime::GetGameTime().count();
+    uint32              modulo       = window ? window : 1;
+    uint32              expired      = 0;
+    std::string         owners;
+
+    for (std::map<uint32, std::set<uint32>>::const_iterator it = botsAuctions.begin(); it != botsAuctions.end(); ++it)
+    {
+        if (it->second.empty())
+        {
+            continue;
+        }
+
+        if (!owners.empty())
+        {
+            owners += ",";
+        }
+
+        owners += std::to_string(it->first);
+
+        for (uint32 auctionId : it->second)
+        {
+            AuctionEntry* auction = auctionHouse->GetAuction(auctionId);
+
+            if (!auction)
+            {
+                continue;
+            }
+
+            time_t expireTime = now + (auctionId % modulo);
+
+            if (auction->expire_time > expireTime)
+            {
+                auction->expire_time = expireTime;
+            }
+
+            expired++;
+        }
+    }
+
+    if (owners.empty())
+    {
+        return 0;
+    }
+
+    //
+    // Same computation on the database side, with a single statement for the whole house
+    //
+
+    CharacterDatabase.Execute("UPDATE auctionhouse SET time = LEAST(time, {} + MOD(id, {})) WHERE houseid = {} AND itemowner IN ({})", uint64(now), modulo, AHID, owners);
+
+    gDbStats.Count(AHB_DB_EXPIRE, AHB_DB_ASYNC);
+
+    if (DebugOutConfig)
+    {
+        LOG_INFO("module", "AHBot: expired {} auctions for auctionhouse {} over {} seconds", expired, AHID, window);
+    }
+
+    return expired;
+}
+
+bool AHBConfig::loadCheckpoint(std::set<uint32> const& botsIds)
+{
+    //
+    // The last buyer runs are valid whatever happened to the auctions
+    //
+
+    std::map<uint32, std::set<uint32>> auctions;
+
+    checkpointRuns.clear();
+
+    QueryResult result = WorldDatabase.Query("SELECT bot, lastrun, auctions FROM mod_auctionhousebot_checkpoint_bots WHERE auctionhouse = {}", AHID);
+
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            uint32 botId  = fields[0].Get<uint32>();
+
+            checkpointRuns[botId] = fields[1].Get<uint32>();
+            auctions[botId]       = getCommaSeparatedIntegers(fields[2].Get<std::string>());
+
+            auctions[botId].erase(0);
+        } while (result->NextRow());
+    }
+
+    result = WorldDatabase.Query("SELECT time, epoch, auctions, lastid, onlybots, counts FROM mod_auctionhousebot_checkpoint WHERE auctionhouse = {}", AHID);
+
+    gDbStats.Count(AHB_DB_CHECKPOINT, AHB_DB_SYNC, 2);
+
+    if (!result)
+    {
+        return false;
+    }
+
+    Field* fields = result->Fetch();
+
+    uint32 taken    = fields[0].Get<uint32>();
+    uint32 count    = fields[2].Get<uint32>();
+    uint32 lastId   = fields[3].Get<uint32>();
+    bool   onlyBots = fields[4].Get<bool>();
+
+    checkpointEpoch = fields[1].Get<uint32>();
+
+    std::vector<uint32> counts = getCommaSeparatedList(fields[5].Get<std::string>());
+
+    //
+    // Delta check: auctions only get higher ids, so the same number of auctions
+    // and the same highest id mean that nothing was listed or removed since
+    //
+
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(GetAHFID());
+    uint32              currentId    = auctionHouse->Getcount() ? std::prev(auctionHouse->GetAuctionsEnd())->first : 0;
+    std::set<uint32>    checkpointed;
+
+    for (auto const& bot : auctions)
+    {
+        checkpointed.insert(bot.first);
+    }
+
+    if (count != auctionHouse->Getcount() || lastId != currentId || onlyBots != ConsiderOnlyBotAuctions ||
+        checkpointed != botsIds || counts.size() != AHB_YELLOW_I + 1)
+    {
+        LOG_INFO("module", "AHBot: checkpoint of the auctionhouse {} is outdated ({} auctions up to {}, now {} up to {}), recounting", AHID, count, lastId, auctionHouse->Getcount(), currentId);
+        return false;
+    }
+
+    //
+    // Resume
+    //
+
+    ResetItemCounts();
+
+    for (uint32 i = 0; i < AHB_YELLOW_I + 1; ++i)
+    {
+        SetItemCounts(i, counts[i]);
+    }
+
+    botsAuctions.clear();
+
+    for (auto& bot : auctions)
+    {
+        if (!bot.second.empty())
+        {
+            botsAuctions[bot.first].swap(bot.second);
+        }
+    }
+
+    LOG_INFO("module", "AHBot: auctionhouse {} resumed from the checkpoint taken {} seconds ago (epoch {}, {} auctions)", AHID, uint32(std::max<int64>(0, int64(time(NULL)) - taken)), checkpointEpoch, count);
+
+    return true;
+}
+
+void AHBConfig::SaveCheckpoint(std::map<uint32, uint32> const& lastRuns)
+{
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(GetAHFID());
+    uint32              lastId       = auctionHouse->Getcount() ? std::prev(auctionHouse->GetAuctionsEnd())->first : 0;
+    std::string         counts;
+
+    for (uint32 i = 0; i < AHB_YELLOW_I + 1; ++i)
+    {
+        if (i)
+        {
+            counts += ",";
+        }
+
+        counts += std::to_string(GetItemCounts(i));
+    }
+
+    //
+    // A single transaction, so that a checkpoint is never read half written
+    //
+
+    WorldDatabaseTransaction trans = WorldDatabase.BeginTransaction();
+
+    trans->Append("REPLACE INTO mod_auctionhousebot_checkpoint (auctionhouse, time, epoch, auctions, lastid, onlybots, counts) VALUES ({}, {}, {}, {}, {}, {}, '{}')",
+        AHID, uint32(time(NULL)), checkpointEpoch, auctionHouse->Getcount(), lastId, ConsiderOnlyBotAuctions ? 1 : 0, counts);
+    gDbStats.Count(AHB_DB_CHECKPOINT, AHB_DB_APPEND);
+
+    trans->Append("DELETE FROM mod_auctionhousebot_checkpoint_bots WHERE auctionhouse = {}", AHID);
+    gDbStats.Count(AHB_DB_CHECKPOINT, AHB_DB_APPEND);
+
+    for (auto const& run : lastRuns)
+    {
+        std::string ids;
+
+        std::map<uint32, std::set<uint32>>::const_iterator it = botsAuctions.find(run.first);
+
+        if (it != botsAuctions.end())
+        {
+            for (uint32 auctionId : it->second)
+            {
+                if (!ids.empty())
+                {
+                    ids += ",";
+                }
+
+                ids += std::to_string(auctionId);
+            }
+        }
+
+        trans->Append("INSERT INTO mod_auctionhousebot_checkpoint_bots (auctionhouse, bot, lastrun, auctions) VALUES ({}, {}, {}, '{}')", AHID, run.first, run.second, ids);
+        gDbStats.Count(AHB_DB_CHECKPOINT, AHB_DB_APPEND);
+    }
+
+    WorldDatabase.DirectCommitTransaction(trans);
+    gDbStats.Count(AHB_DB_CHECKPOINT, AHB_DB_SYNC);
+
+    if (DebugOutConfig)
+    {
+        LOG_INFO("module", "AHBot: checkpoint of the auctionhouse {} saved (epoch {}, {} auctions, {} bots)", AHID, checkpointEpoch, auctionHouse->Getcount(), lastRuns.size());
+    }
+}
+
+uint32 AHBConfig::GetCheckpointRun(uint32 botId, uint32 fallback)
+{
+    std::map<uint32, uint32>::const_iterator it = checkpointRuns.find(botId);
+
+    if (it == checkpointRuns.end() || it->second > fallback)
+    {
+        return fallback;
+    }
+
+    return it->second;
+}
+
+void AHBConfig::Commands(AHBotCommand command, uint32 col, char* args)
+{
+    //
+    // Retrive the item quality
+    //
+
+    std::string color;
+
+    switch (col)
+    {
+    case AHB_GREY:
+        color = "grey";
+        break;
+    case AHB_WHITE:
+        color = "white";
+        break;
+    case AHB_GREEN:
+        color = "green";
+        break;
+    case AHB_BLUE:
+        color = "blue";
+        break;
+    case AHB_PURPLE:
+        color = "purple";
+        break;
+    case AHB_ORANGE:
+        color = "orange";
+        break;
+    case AHB_YELLOW:
+        color = "yellow";
+        break;
+    default:
+        break;
+    }
+
+    //
+    // Apply the change once to the shared configuration, then persist it with a single statement
+    //
+
+    std::string assignments;
+
+    switch (command)
+    {
+    case AHBotCommand::buyer:
+    {
+        char* param1 = strtok(args, " ");
+        AHBBuyer     = (uint32)strtoul(param1, NULL, 0) != 0;
+
+        break;
+    }
+    case AHBotCommand::seller:
+    {
+        char* param1 = strtok(args, " ");
+        AHBSeller    = (uint32)strtoul(param1, NULL, 0) != 0;
+
+        break;
+    }
+    case AHBotCommand::useMarketPrice:
+    {
+        char* param1      = strtok(args, " ");
+        SellAtMarketPrice = (uint32)strtoul(param1, NULL, 0) != 0;
+
+        InitializePricing();
+
+        break;
+    }
+    case AHBotCommand::ahexpire:
+    {
+        char * param1 = args ? strtok(args, " ") : NULL;
+        uint32 window = param1 ? (uint32) strtoul(param1, NULL, 0) : 0;
+
+        ExpireBotAuctions(window);
+
+        break;
+    }
+    case AHBotCommand::minitems:
+    {
+        char * param1   = strtok(args, " ");
+        uint32 minItems = (uint32) strtoul(param1, NULL, 0);
+
+        SetMinItems(minItems);
+
+        assignments = Acore::StringFormat("minitems = '{}'", minItems);
+
+        break;
+    }
+    case AHBotCommand::maxitems:
+    {
+        char * param1   = strtok(args, " ");
+        uint32 maxItems = (uint32) strtoul(param1, NULL, 0);
+
+        SetMaxItems(maxItems);
+        CalculatePercents();
+
+        assignments = Acore::StringFormat("maxitems = '{}'", maxItems);
+
+        break;
+    }
+    case AHBotCommand::percentages:
+    {
+        char * param1   = strtok(args, " ");
+        char * param2   = strtok(NULL, " ");
+        char * param3   = strtok(NULL, " ");
+        char * param4   = strtok(NULL, " ");
+        char * param5   = strtok(NULL, " ");
+        char * param6   = strtok(NULL, " ");
+        char * param7   = strtok(NULL, " ");
+        char * param8   = strtok(NULL, " ");
+        char * param9   = strtok(NULL, " ");
+        char * param10  = strtok(NULL, " ");
+        char * param11  = strtok(NULL, " ");
+        char * param12  = strtok(NULL, " ");
+        char * param13  = strtok(NULL, " ");
+        char * param14  = strtok(NULL, " ");
+
+        uint32 greytg   = (uint32) strtoul(param1, NULL, 0);
+        uint32 whitetg  = (uint32) strtoul(param2, NULL, 0);
+        uint32 greentg  = (uint32) strtoul(param3, NULL, 0);
+        uint32 bluetg   = (uint32) strtoul(param4, NULL, 0);
+        uint32 purpletg = (uint32) strtoul(param5, NULL, 0);
+        uint32 orangetg = (uint32) strtoul(param6, NULL, 0);
+        uint32 yellowtg = (uint32) strtoul(param7, NULL, 0);
+        uint32 greyi    = (uint32) strtoul(param8, NULL, 0);
+        uint32 whitei   = (uint32) strtoul(param9, NULL, 0);
+        uint32 greeni   = (uint32) strtoul(param10, NULL, 0);
+        uint32 bluei    = (uint32) strtoul(param11, NULL, 0);
+        uint32 purplei  = (uint32) strtoul(param12, NULL, 0);
+        uint32 orangei  = (uint32) strtoul(param13, NULL, 0);
+        uint32 yellowi  = (uint32) strtoul(param14, NULL, 0);
+
+        //
+        // Setup the percentage in the configuration first, so validity test can be performed
+        //
+
+        SetPercentages(greytg, whitetg, greentg, bluetg, purpletg, orangetg, yellowtg, greyi, whitei, greeni, bluei, purplei, orangei, yellowi);
+
+        assignments = Acore::StringFormat(
+            "percentgreytradegoods = '{}', percentwhitetradegoods = '{}', percentgreentradegoods = '{}', percentbluetradegoods = '{}', "
+            "percentpurpletradegoods = '{}', percentorangetradegoods = '{}', percentyellowtradegoods = '{}', "
+            "percentgreyitems = '{}', percentwhiteitems = '{}', percentgreenitems = '{}', percentblueitems = '{}', "
+            "percentpurpleitems = '{}', percentorangeitems = '{}', percentyellowitems = '{}'",
+            GetPercentages(AHB_GREY_TG), GetPercentages(AHB_WHITE_TG), GetPercentages(AHB_GREEN_TG), GetPercentages(AHB_BLUE_TG),
+            GetPercentages(AHB_PURPLE_TG), GetPercentages(AHB_ORANGE_TG), GetPercentages(AHB_YELLOW_TG),
+            GetPercentages(AHB_GREY_I), GetPercentages(AHB_WHITE_I), GetPercentages(AHB_GREEN_I), GetPercentages(AHB_BLUE_I),
+            GetPercentages(AHB_PURPLE_I), GetPercentages(AHB_ORANGE_I), GetPercentages(AHB_YELLOW_I));
+
+        break;
+    }
+    case AHBotCommand::minprice:
+    {
+        char * param1   = strtok(args, " ");
+        uint32 minPrice = (uint32) strtoul(param1, NULL, 0);
+
+        SetMinPrice(col, minPrice);
+
+        assignments = Acore::StringFormat("minprice{} = '{}'", color, minPrice);
+
+        break;
+    }
+    case AHBotCommand::maxprice:
+    {
+        char * param1   = strtok(args, " ");
+        uint32 maxPrice = (uint32) strtoul(param1, NULL, 0);
+
+        SetMaxPrice(col, maxPrice);
+
+        assignments = Acore::StringFormat("maxprice{} = '{}'", color, maxPrice);
+
+        break;
+    }
+    case AHBotCommand::minbidprice:
+    {
+        char * param1      = strtok(args, " ");
+        uint32 minBidPrice = (uint32) strtoul(param1, NULL, 0);
+
+        SetMinBidPrice(col, minBidPrice);
+
+        assignments = Acore::StringFormat("minbidprice{} = '{}'", color, minBidPrice);
+
+        break;
+    }
+    case AHBotCommand::maxbidprice:
+    {
+        char * param1      = strtok(args, " ");
+        uint32 maxBidPrice = (uint32) strtoul(param1, NULL, 0);
+
+        SetMaxBidPrice(col, maxBidPrice);
+
+        assignments = Acore::StringFormat("maxbidprice{} = '{}'", color, maxBidPrice);
+
+        break;
+    }
+    case AHBotCommand::maxstack:
+    {
+        char * param1   = strtok(args, " ");
+        uint32 maxStack = (uint32) strtoul(param1, NULL, 0);
+
+        SetMaxStack(col, maxStack);
+
+        assignments = Acore::StringFormat("maxstack{} = '{}'", color, maxStack);
+
+        break;
+    }
+    case AHBotCommand::buyerprice:
+    {
+        char * param1     = strtok(args, " ");
+        uint32 buyerPrice = (uint32) strtoul(param1, NULL, 0);
+
+        SetBuyerPrice(col, buyerPrice);
+
+        assignments = Acore::StringFormat("buyerprice{} = '{}'", color, buyerPrice);
+
+        break;
+    }
+    case AHBotCommand::bidinterval:
+    {
+        char * param1      = strtok(args, " ");
+        uint32 bidInterval = (uint32) strtoul(param1, NULL, 0);
+
+        SetBiddingInterval(bidInterval);
+
+        assignments = Acore::StringFormat("buyerbiddinginterval = '{}'", bidInterval);
+
+        break;
+    }
+    case AHBotCommand::bidsperinterval:
+    {
+        char * param1          = strtok(args, " ");
+        uint32 bidsPerInterval = (uint32) strtoul(param1, NULL, 0);
+
+        SetBidsPerInterval(bidsPerInterval);
+
+        assignments = Acore::StringFormat("buyerbidsperinterval = '{}'", bidsPerInterval);
+
+        break;
+    }
+    default:
+        break;
+    }
+
+    //
+    // The switches are runtime only and are not stored in the database
+    //
+
+    if (!assignments.empty())
+    {
+        WorldDatabase.Execute("UPDATE mod_auctionhousebot SET {} WHERE auctionhouse = '{}'", assignments, AHID);
+
+        gDbStats.Count(AHB_DB_COMMAND, AHB_DB_ASYNC);
+    }
+
+    //
+    // Quotas and prices may not match the other houses anymore, or match them now
+    //
+
+    AHBUpdateMirrors();
+}
+
+void AHBConfig::Initialize(std::set<uint32> botsIds)
+{
+    InitializeFromFile();
+    InitializePricing();
+    InitializeFromSql(botsIds);
+    InitializeBins();
+}
+
+void AHBConfig::InitializeFromFile()
+{
+    //
+    // Load from, the configuration file
+    //
+
+    DebugOut                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG"        , false);
+    DebugOutConfig                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_CONFIG" , false);
+    DebugOutFilters                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_FILTERS", false);
+    DebugOutBuyer                  = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_BUYER"  , false);
+    DebugOutSeller                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_SELLER" , false);
+
+    TraceSeller                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.TRACE_SELLER" , false);
+    TraceBuyer                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.TRACE_BUYER"  , false);
+
+    AHBSeller                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.EnableSeller"           , false);
+    AHBBuyer                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.EnableBuyer"            , false);
+    SellMethod                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseBuyPriceForSeller"   , false);
+    BuyMethod                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseBuyPriceForBuyer"    , false);
+    SellAtMarketPrice              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseMarketPriceForSeller", false);
+    MarketResetThreshold           = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketResetThreshold"   , 25);
+    MarketPersistence              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.MarketPersistence"      , true);
+    MarketFlushInterval            = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketFlushInterval"    , 60);
+    MarketFlushBatch               = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketFlushBatch"       , 100);
+    MarketSellQuantileMin          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketSellQuantileMin"  , 40);
+    MarketSellQuantileMax          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketSellQuantileMax"  , 60);
+    MarketBuyQuantile              = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketBuyQuantile"      , 0);
+    MarketMergeHouses              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.MarketMergeHouses"      , false);
+    MarketVariantMinSamples        = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketVariantMinSamples", 5);
+    MetricsFile                    = sConfigMgr->GetOption<std::string>("AuctionHouseBot.MetricsFile", "");
+    MetricsInterval                = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MetricsInterval"        , 15);
+    RecordFile                     = sConfigMgr->GetOption<std::string>("AuctionHouseBot.RecordFile", "");
+    HookTimings                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.HookTimings"            , false);
+    LoadTestAccount                = sConfigMgr->GetOption<uint32>("AuctionHouseBot.LoadTestAccount"        , 0);
+    LoadTestGUID                   = sConfigMgr->GetOption<uint32>("AuctionHouseBot.LoadTestGUID"           , 0);
+    LoadTestBidderGUID             = sConfigMgr->GetOption<uint32>("AuctionHouseBot.LoadTestBidderGUID"     , 0);
+    ColumnarDirectory              = sConfigMgr->GetOption<std::string>("AuctionHouseBot.ColumnarDirectory", "");
+    ColumnarInterval               = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ColumnarInterval"       , 300);
+    RandomSeed                     = sConfigMgr->GetOption<uint32>("AuctionHouseBot.RandomSeed"             , 0);
+    PricingStrategy                = sConfigMgr->GetOption<uint32>("AuctionHouseBot.PricingStrategy"        , 0);
+    Checkpoint                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Checkpoint"             , true);
+    SweepInterval                  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.SweepInterval"          , 0);
+    SweepRange                     = sConfigMgr->GetOption<uint32>("AuctionHouseBot.SweepRange"             , 10000);
+    BundleWeights                  = getBundleWeights(sConfigMgr->GetOption<std::string>("AuctionHouseBot.BundleWeights", ""));
+    SharedSellPlan                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.SharedSellPlan"         , false);
+    SharedSellPerturbation         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.SharedSellPerturbation" , 10);
+    PopulationScaling              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.PopulationScaling"      , false);
+    PopulationFull                 = sConfigMgr->GetOption<uint32>("AuctionHouseBot.PopulationFull"         , 500);
+    PopulationFloor                = sConfigMgr->GetOption<uint32>("AuctionHouseBot.PopulationFloor"        , 25);
+    PopulationCeiling              = sConfigMgr->GetOption<uint32>("AuctionHouseBot.PopulationCeiling"      , 100);
+    PopulationSmoothing            = sConfigMgr->GetOption<uint32>("AuctionHouseBot.PopulationSmoothing"    , 20);
+
+    if (MarketSellQuantileMin > MarketSellQuantileMax)
+    {
+        MarketSellQuantileMin = MarketSellQuantileMax;
+    }
+    DuplicatesCount                = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DuplicatesCount"        , 0);
+    DivisibleStacks                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DivisibleStacks"        , false);
+    ElapsingTimeClass              = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DuplicatesCount"        , 1);
+    ConsiderOnlyBotAuctions        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.ConsiderOnlyBotAuctions", false);
+    ItemsPerCycle                  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ItemsPerCycle"          , 200);
+
+    //
+    // Flags: item types
+    //
+
+    Vendor_Items                   = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.VendorItems"      , false);
+    Loot_Items                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.LootItems"        , true);
+    Other_Items                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.OtherItems"       , false);
+    Vendor_TGs                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.VendorTradeGoods" , false);
+    Loot_TGs                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.LootTradeGoods"   , true);
+    Other_TGs                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.OtherTradeGoods"  , false);
+
+    //
+    // Flags: items binding
+    //
+
+    No_Bind                        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.No_Bind"             , true);
+    Bind_When_Picked_Up            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Picked_Up" , false);
+    Bind_When_Equipped             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Equipped"  , true);
+    Bind_When_Use                  = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Use"       , true);
+    Bind_Quest_Item                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_Quest_Item"     , false);
+
+    //
+    // Flags: misc
+    //
+
+    DisableConjured                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableConjured"               , false);
+    DisableGems                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableGems"                   , false);
+    DisableMoney                   = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMoney"                  , false);
+    DisableMoneyLoot               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMoneyLoot"              , false);
+    DisableLootable                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableLootable"               , false);
+    DisableKeys                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableKeys"                   , false);
+    DisableDuration                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDuration"               , false);
+    DisableBOP_Or_Quest_NoReqLevel = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableBOP_Or_Quest_NoReqLevel", false);
+
+    //
+    // Flags: items per class
+    //
+
+    DisableWarriorItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableWarriorItems"    , false);
+    DisablePaladinItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisablePaladinItems"    , false);
+    DisableHunterItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableHunterItems"     , false);
+    DisableRogueItems              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableRogueItems"      , false);
+    DisablePriestItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisablePriestItems"     , false);
+    DisableDKItems                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDKItems"         , false);
+    DisableShamanItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableShamanItems"     , false);
+    DisableMageItems               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMageItems"       , false);
+    DisableWarlockItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableWarlockItems"    , false);
+    DisableUnusedClassItems        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableUnusedClassItems", false);
+    DisableDruidItems              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDruidItems"      , false);
+
+    //
+    // Items level and skills
+    //
+
+    DisableItemsBelowLevel         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowLevel"       , 0);
+    DisableItemsAboveLevel         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveLevel"       , 0);
+    DisableItemsBelowGUID          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowGUID"        , 0);
+    DisableItemsAboveGUID          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveGUID"        , 0);
+    DisableItemsBelowReqLevel      = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqLevel"    , 0);
+    DisableItemsAboveReqLevel      = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqLevel"    , 0);
+    DisableItemsBelowReqSkillRank  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqSkillRank", 0);
+    DisableItemsAboveReqSkillRank  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqSkillRank", 0);
+
+    //
     // Trade goods level and skills
     //
 
@@ -2133,83 +3247,91 @@ void AHBConfig::InitializeFromFile()
 void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
 {
     //
-    // Load min and max items
+    // Load the settings of the house in a single round trip
     //
 
-    SetMinItems(WorldDatabase.Query("SELECT minitems FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxItems(WorldDatabase.Query("SELECT maxitems FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
+    QueryResult settings = WorldDatabase.Query(
+        "SELECT minitems, maxitems, "
+        "percentgreytradegoods, percentwhitetradegoods, percentgreentradegoods, percentbluetradegoods, percentpurpletradegoods, percentorangetradegoods, percentyellowtradegoods, "
+        "percentgreyitems, percentwhiteitems, percentgreenitems, percentblueitems, percentpurpleitems, percentorangeitems, percentyellowitems, "
+        "minpricegrey, maxpricegrey, minpricewhite, maxpricewhite, minpricegreen, maxpricegreen, minpriceblue, maxpriceblue, "
+        "minpricepurple, maxpricepurple, minpriceorange, maxpriceorange, minpriceyellow, maxpriceyellow, "
+        "minbidpricegrey, maxbidpricegrey, minbidpricewhite, maxbidpricewhite, minbidpricegreen, maxbidpricegreen, minbidpriceblue, maxbidpriceblue, "
+        "minbidpricepurple, maxbidpricepurple, minbidpriceorange, maxbidpriceorange, minbidpriceyellow, maxbidpriceyellow, "
+        "maxstackgrey, maxstackwhite, maxstackgreen, maxstackblue, maxstackpurple, maxstackorange, maxstackyellow, "
+        "buyerpricegrey, buyerpricewhite, buyerpricegreen, buyerpriceblue, buyerpricepurple, buyerpriceorange, buyerpriceyellow, "
+        "buyerbiddinginterval, buyerbidsperinterval "
+        "FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID());
+
+    gDbStats.Count(AHB_DB_CONFIG_LOAD, AHB_DB_SYNC);
+
+    if (settings)
+    {
+        static uint32 const colors[] = { AHB_GREY, AHB_WHITE, AHB_GREEN, AHB_BLUE, AHB_PURPLE, AHB_ORANGE, AHB_YELLOW };
 
-    //
-    // Load percentages
-    //
+        Field* fields = settings->Fetch();
+        uint32 column = 0;
+
+        //
+        // Min and max items
+        //
 
-    uint32 greytg   = WorldDatabase.Query("SELECT percentgreytradegoods   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 whitetg  = WorldDatabase.Query("SELECT percentwhitetradegoods  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 greentg  = WorldDatabase.Query("SELECT percentgreentradegoods  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 bluetg   = WorldDatabase.Query("SELECT percentbluetradegoods   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 purpletg = WorldDatabase.Query("SELECT percentpurpletradegoods FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 orangetg = WorldDatabase.Query("SELECT percentorangetradegoods FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 yellowtg = WorldDatabase.Query("SELECT percentyellowtradegoods FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
+        SetMinItems(fields[column++].Get<uint32>());
+        SetMaxItems(fields[column++].Get<uint32>());
 
-    uint32 greyi    = WorldDatabase.Query("SELECT percentgreyitems        FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 whitei   = WorldDatabase.Query("SELECT percentwhiteitems       FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 greeni   = WorldDatabase.Query("SELECT percentgreenitems       FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 bluei    = WorldDatabase.Query("SELECT percentblueitems        FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 purplei  = WorldDatabase.Query("SELECT percentpurpleitems      FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 orangei  = WorldDatabase.Query("SELECT percentorangeitems      FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 yellowi  = WorldDatabase.Query("SELECT percentyellowitems      FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
+        //
+        // Percentages
+        //
 
-    SetPercentages(greytg, whitetg, greentg, bluetg, purpletg, orangetg, yellowtg, greyi, whitei, greeni, bluei, purplei, orangei, yellowi);
+        uint32 percentages[AHB_YELLOW_I + 1];
 
-    // 
-    // Load min and max prices
-    // 
+        for (uint32 i = 0; i < AHB_YELLOW_I + 1; ++i)
+        {
+            percentages[i] = fields[column++].Get<uint32>();
+        }
 
-    SetMinPrice(AHB_GREY  , WorldDatabase.Query("SELECT minpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_GREY  , WorldDatabase.Query("SELECT maxpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_WHITE , WorldDatabase.Query("SELECT minpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_WHITE , WorldDatabase.Query("SELECT maxpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_GREEN , WorldDatabase.Query("SELECT minpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_GREEN , WorldDatabase.Query("SELECT maxpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_BLUE  , WorldDatabase.Query("SELECT minpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_BLUE  , WorldDatabase.Query("SELECT maxpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_PURPLE, WorldDatabase.Query("SELECT minpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_PURPLE, WorldDatabase.Query("SELECT maxpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_ORANGE, WorldDatabase.Query("SELECT minpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_ORANGE, WorldDatabase.Query("SELECT maxpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_YELLOW, WorldDatabase.Query("SELECT minpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_YELLOW, WorldDatabase.Query("SELECT maxpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
+        SetPercentages(percentages[AHB_GREY_TG], percentages[AHB_WHITE_TG], percentages[AHB_GREEN_TG], percentages[AHB_BLUE_TG],
+                       percentages[AHB_PURPLE_TG], percentages[AHB_ORANGE_TG], percentages[AHB_YELLOW_TG],
+                       percentages[AHB_GREY_I], percentages[AHB_WHITE_I], percentages[AHB_GREEN_I], percentages[AHB_BLUE_I],
+                       percentages[AHB_PURPLE_I], percentages[AHB_ORANGE_I], percentages[AHB_YELLOW_I]);
 
-    // 
-    // Load min and max bid prices
-    // 
+        //
+        // Min and max prices, min and max bid prices, max stacks
+        //
 
-    SetMinBidPrice(AHB_GREY  , WorldDatabase.Query("SELECT minbidpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_GREY  , WorldDatabase.Query("SELECT maxbidpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_WHITE , WorldDatabase.Query("SELECT minbidpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_WHITE , WorldDatabase.Query("SELECT maxbidpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_GREEN , WorldDatabase.Query("SELECT minbidpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_GREEN , WorldDatabase.Query("SELECT maxbidpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_BLUE  , WorldDatabase.Query("SELECT minbidpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_BLUE  , WorldDatabase.Query("SELECT maxbidpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_PURPLE, WorldDatabase.Query("SELECT minbidpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_PURPLE, WorldDatabase.Query("SELECT maxbidpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_ORANGE, WorldDatabase.Query("SELECT minbidpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_ORANGE, WorldDatabase.Query("SELECT maxbidpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_YELLOW, WorldDatabase.Query("SELECT minbidpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_YELLOW, WorldDatabase.Query("SELECT maxbidpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
+        for (uint32 color : colors)
+        {
+            SetMinPrice(color, fields[column++].Get<uint32>());
+            SetMaxPrice(color, fields[column++].Get<uint32>());
+        }
 
-    // 
-    // Load max stacks
-    // 
+        for (uint32 color : colors)
+        {
+            SetMinBidPrice(color, fields[column++].Get<uint32>());
+            SetMaxBidPrice(color, fields[column++].Get<uint32>());
+        }
 
-    SetMaxStack(AHB_GREY  , WorldDatabase.Query("SELECT maxstackgrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_WHITE , WorldDatabase.Query("SELECT maxstackwhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_GREEN , WorldDatabase.Query("SELECT maxstackgreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_BLUE  , WorldDatabase.Query("SELECT maxstackblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_PURPLE, WorldDatabase.Query("SELECT maxstackpurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_ORANGE, WorldDatabase.Query("SELECT maxstackorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_YELLOW, WorldDatabase.Query("SELECT maxstackyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
+        for (uint32 color : colors)
+        {
+            SetMaxStack(color, fields[column++].Get<uint32>());
+        }
+
+        //
+        // Auctions buyer
+        //
+
+        for (uint32 color : colors)
+        {
+            SetBuyerPrice(color, fields[column++].Get<uint32>());
+        }
+
+        SetBiddingInterval(fields[column++].Get<uint32>());
+        SetBidsPerInterval(fields[column++].Get<uint32>());
+    }
+    else
+    {
+        LOG_ERROR("module", "AHBot: no settings for the auction house {} in mod_auctionhousebot", GetAHID());
+    }
 
     if (DebugOutConfig)
     {
@@ -2273,131 +3395,14 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
     }
 
     //
-    // Reset the situation of the auction house
-    //
-
-    ResetItemCounts();
-
-    //
-    // Update the situation of the auction house
-    //
-
-    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(GetAHFID());
-    uint32              auctions     = auctionHouse->Getcount();
-
-    if (auctions)
-    {
-        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
-        {
-            AuctionEntry* Aentry = itr->second;
-            Item*         item   = sAuctionMgr->GetAItem(Aentry->item_guid);
-
-            //
-            // If it has to only consider the bots auctions, skip the ones belonging to the players
-            //
-
-            if (ConsiderOnlyBotAuctions)
-            {
-                if (botsIds.find(Aentry->owner.GetCounter()) == botsIds.end())
-                {
-                    continue;
-                }
-            }
-
-            if (item)
-            {
-                ItemTemplate const* prototype = item->GetTemplate();
-
-                if (prototype)
-                {
-                    switch (prototype->Quality)
-                    {
-                    case AHB_GREY:
-                        if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
-                        {
-                            IncItemCounts(AHB_GREY_TG);
-                        }
-                        else
-                        {
-                            IncItemCounts(AHB_GREY_I);
-                        }
-                        break;
-
-                    case AHB_WHITE:
-                        if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
-                        {
-                            IncItemCounts(AHB_WHITE_TG);
-                        }
-                        else
-                        {
-                            IncItemCounts(AHB_WHITE_I);
-                        }
-
-                        break;
-
-                    case AHB_GREEN:
-                        if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
-                        {
-                            IncItemCounts(AHB_GREEN_TG);
-                        }
-                        else
-                        {
-                            IncItemCounts(AHB_GREEN_I);
-                        }
-
-                        break;
-
-                    case AHB_BLUE:
-                        if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
-                        {
-                            IncItemCounts(AHB_BLUE_TG);
-                        }
-                        else
-                        {
-                            IncItemCounts(AHB_BLUE_I);
-                        }
-
-                        break;
-
-                    case AHB_PURPLE:
-                        if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
-                        {
-                            IncItemCounts(AHB_PURPLE_TG);
-                        }
-                        else
-                        {
-                            IncItemCounts(AHB_PURPLE_I);
-                        }
-
-                        break;
-
-                    case AHB_ORANGE:
-                        if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
-                        {
-                            IncItemCounts(AHB_ORANGE_TG);
-                        }
-                        else
-                        {
-                            IncItemCounts(AHB_ORANGE_I);
-                        }
-
-                        break;
-
-                    case AHB_YELLOW:
-                        if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
-                        {
-                            IncItemCounts(AHB_YELLOW_TG);
-                        }
-                        else
-                        {
-                            IncItemCounts(AHB_YELLOW_I);
-                        }
-
-                        break;
-                    }
-                }
-            }
-        }
+    // Update the situation of the auction house, from the last checkpoint when it is still valid
+    //
+
+    if (!Checkpoint || !loadCheckpoint(botsIds))
+    {
+        InitializeItemCounts(botsIds);
+
+        checkpointEpoch++;
     }
 
     if (DebugOutConfig)
@@ -2419,30 +3424,6 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
         LOG_INFO("module", "    Yellow Items       {}", GetItemCounts(AHB_YELLOW_I));
     }
 
-    //
-    // Auctions buyer
-    //
-
-    SetBuyerPrice(AHB_GREY  , WorldDatabase.Query("SELECT buyerpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_WHITE , WorldDatabase.Query("SELECT buyerpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_GREEN , WorldDatabase.Query("SELECT buyerpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_BLUE  , WorldDatabase.Query("SELECT buyerpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_PURPLE, WorldDatabase.Query("SELECT buyerpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_ORANGE, WorldDatabase.Query("SELECT buyerpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_YELLOW, WorldDatabase.Query("SELECT buyerpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-
-    //
-    // Load bidding interval
-    //
-
-    SetBiddingInterval(WorldDatabase.Query("SELECT buyerbiddinginterval FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-
-    //
-    // Load bids per interval
-    //
-
-    SetBidsPerInterval(WorldDatabase.Query("SELECT buyerbidsperinterval FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-
     if (DebugOutConfig)
     {
         LOG_INFO("module", "Current Settings for Auctionhouse {} buyer", GetAHID());
@@ -2465,6 +3446,8 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
 
     QueryResult result = WorldDatabase.Query("SELECT item FROM mod_auctionhousebot_disabled_items");
 
+    gDbStats.Count(AHB_DB_CONFIG_LOAD, AHB_DB_SYNC, 1);
+
     if (result)
     {
         do
@@ -2487,6 +3470,8 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
 
     QueryResult npcResults = WorldDatabase.Query("SELECT distinct item FROM npc_vendor");
 
+    gDbStats.Count(AHB_DB_CONFIG_LOAD, AHB_DB_SYNC, 1);
+
     if (npcResults)
     {
         do
@@ -2527,6 +3512,8 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
         "SELECT item FROM prospecting_loot_template   UNION "
         "SELECT item FROM skinning_loot_template");
 
+    gDbStats.Count(AHB_DB_CONFIG_LOAD, AHB_DB_SYNC, 1);
+
     if (itemsResults)
     {
         do
@@ -2550,14 +3537,216 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
     }
 }
 
+void AHBConfig::InitializeItemCounts(std::set<uint32> const& botsIds)
+{
+    //
+    // Reset the situation of the auction house
+    //
+
+    ResetItemCounts();
+    botsAuctions.clear();
+
+    //
+    // Count the auctions already listed
+    //
+
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(GetAHFID());
+    uint32              auctions     = auctionHouse->Getcount();
+
+    if (auctions)
+    {
+        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
+        {
+            AuctionEntry* Aentry = itr->second;
+            Item*         item   = sAuctionMgr->GetAItem(Aentry->item_guid);
+
+            CountAuction(Aentry->owner.GetCounter(), Aentry->Id, item ? item->GetTemplate() : NULL, botsIds);
+        }
+    }
+}
+
+//
+// One auction of the startup scan, also fed with generated auctions by the scaling benchmark
+//
+
+void AHBConfig::CountAuction(uint32 owner, uint32 auctionId, ItemTemplate const* prototype, std::set<uint32> const& botsIds)
+{
+    //
+    // Build the index of the bots auctions
+    //
+
+    if (botsIds.find(owner) != botsIds.end())
+    {
+        AddBotAuction(owner, auctionId);
+    }
+
+    //
+    // If it has to only consider the bots auctions, skip the ones belonging to the players
+    //
+
+    if (ConsiderOnlyBotAuctions)
+    {
+        if (botsIds.find(owner) == botsIds.end())
+        {
+            return;
+        }
+    }
+
+    if (prototype)
+    {
+        switch (prototype->Quality)
+        {
+        case AHB_GREY:
+            if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+            {
+                IncItemCounts(AHB_GREY_TG);
+            }
+            else
+            {
+                IncItemCounts(AHB_GREY_I);
+            }
+            break;
+
+        case AHB_WHITE:
+            if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+            {
+                IncItemCounts(AHB_WHITE_TG);
+            }
+            else
+            {
+                IncItemCounts(AHB_WHITE_I);
+            }
+
+            break;
+
+        case AHB_GREEN:
+            if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+            {
+                IncItemCounts(AHB_GREEN_TG);
+            }
+            else
+            {
+                IncItemCounts(AHB_GREEN_I);
+            }
+
+            break;
+
+        case AHB_BLUE:
+            if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+            {
+                IncItemCounts(AHB_BLUE_TG);
+            }
+            else
+            {
+                IncItemCounts(AHB_BLUE_I);
+            }
+
+            break;
+
+        case AHB_PURPLE:
+            if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+            {
+                IncItemCounts(AHB_PURPLE_TG);
+            }
+            else
+            {
+                IncItemCounts(AHB_PURPLE_I);
+            }
+
+            break;
+
+        case AHB_ORANGE:
+            if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+            {
+                IncItemCounts(AHB_ORANGE_TG);
+            }
+            else
+            {
+                IncItemCounts(AHB_ORANGE_I);
+            }
+
+            break;
+
+        case AHB_YELLOW:
+            if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+            {
+                IncItemCounts(AHB_YELLOW_TG);
+            }
+            else
+            {
+                IncItemCounts(AHB_YELLOW_I);
+            }
+
+            break;
+        }
+    }
+}
+
 void AHBConfig::InitializeBins()
+{
+    InitializeBins(sObjectMgr->GetItemTemplateStore());
+
+    // 
+    // Perform reporting and the last check: if no items are disabled or in the whitelist clear the bin making the selling useless
+    // 
+
+    LOG_INFO("module", "AHBot: Configuration for ah {}", AHID);
+
+    if (SellerWhiteList.size() == 0)
+    {
+        if (DisableItemStore.size() == 0)
+        {
+            LOG_ERROR("module", "AHBot: No items are disabled or in the whitelist! Selling will be disabled!");
+
+            GreyTradeGoodsBin.clear();
+            WhiteTradeGoodsBin.clear();
+            GreenTradeGoodsBin.clear();
+            BlueTradeGoodsBin.clear();
+            PurpleTradeGoodsBin.clear();
+            OrangeTradeGoodsBin.clear();
+            YellowTradeGoodsBin.clear();
+            GreyItemsBin.clear();
+            WhiteItemsBin.clear();
+            GreenItemsBin.clear();
+            BlueItemsBin.clear();
+            PurpleItemsBin.clear();
+            OrangeItemsBin.clear();
+            YellowItemsBin.clear();
+
+            AHBSeller = false;
+
+            return;
+        }
+
+        LOG_INFO("module", "AHBot: {} disabled items", uint32(DisableItemStore.size()));
+    }
+    else
+    {
+        LOG_INFO("module", "AHBot: Using a whitelist of {} items", uint32(SellerWhiteList.size()));
+    }
+
+    LOG_INFO("module", "AHBot: loaded {} grey   trade goods", uint32(GreyTradeGoodsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} white  trade goods", uint32(WhiteTradeGoodsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} green  trade goods", uint32(GreenTradeGoodsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} blue   trade goods", uint32(BlueTradeGoodsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} purple trade goods", uint32(PurpleTradeGoodsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} orange trade goods", uint32(OrangeTradeGoodsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} yellow trade goods", uint32(YellowTradeGoodsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} grey   items"      , uint32(GreyItemsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} white  items"      , uint32(WhiteItemsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} green  items"      , uint32(GreenItemsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} blue   items"      , uint32(BlueItemsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} purple items"      , uint32(PurpleItemsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} orange items"      , uint32(OrangeItemsBin.size()));
+    LOG_INFO("module", "AHBot: loaded {} yellow items"      , uint32(YellowItemsBin.size()));
+}
+
+void AHBConfig::InitializeBins(ItemTemplateContainer const* its)
 {
     //
     // Exclude items depending on the configuration; whatever passes all the tests is put in the lists.
     //
 
-    ItemTemplateContainer const* its = sObjectMgr->GetItemTemplateStore();
-
     for (ItemTemplateContainer::const_iterator itr = its->begin(); itr != its->end(); ++itr)
     {
 
@@ -3325,77 +4514,104 @@ void AHBConfig::InitializeBins()
             }
         }
     }
+}
 
-    // 
-    // Perform reporting and the last check: if no items are disabled or in the whitelist clear the bin making the selling useless
-    // 
+std::set<uint32> AHBConfig::getCommaSeparatedIntegers(std::string text)
+{
+    std::string       value;
+    std::stringstream stream;
+    std::set<uint32>  ret;
 
-    LOG_INFO("module", "AHBot: Configuration for ah {}", AHID);
+    stream.str(text);
 
-    if (SellerWhiteList.size() == 0)
+    //
+    // Continue to precess comma separated values
+    //
+
+    while (std::getline(stream, value, ','))
     {
-        if (DisableItemStore.size() == 0)
-        {
-            LOG_ERROR("module", "AHBot: No items are disabled or in the whitelist! Selling will be disabled!");
+        ret.insert(atoi(value.c_str()));
+    }
 
-            GreyTradeGoodsBin.clear();
-            WhiteTradeGoodsBin.clear();
-            GreenTradeGoodsBin.clear();
-            BlueTradeGoodsBin.clear();
-            PurpleTradeGoodsBin.clear();
-            OrangeTradeGoodsBin.clear();
-            YellowTradeGoodsBin.clear();
-            GreyItemsBin.clear();
-            WhiteItemsBin.clear();
-            GreenItemsBin.clear();
-            BlueItemsBin.clear();
-            PurpleItemsBin.clear();
-            OrangeItemsBin.clear();
-            YellowItemsBin.clear();
+    return ret;
+}
 
-            AHBSeller = false;
+std::vector<uint32> AHBConfig::getCommaSeparatedList(std::string text)
+{
+    std::string         value;
+    std::stringstream   stream;
+    std::vector<uint32> ret;
 
-            return;
-        }
+    stream.str(text);
 
-        LOG_INFO("module", "AHBot: {} disabled items", uint32(DisableItemStore.size()));
-    }
-    else
+    //
+    // Same as above, keeping the order and the repetitions
+    //
+
+    while (std::getline(stream, value, ','))
     {
-        LOG_INFO("module", "AHBot: Using a whitelist of {} items", uint32(SellerWhiteList.size()));
+        ret.push_back(atoi(value.c_str()));
     }
 
-    LOG_INFO("module", "AHBot: loaded {} grey   trade goods", uint32(GreyTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} white  trade goods", uint32(WhiteTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} green  trade goods", uint32(GreenTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} blue   trade goods", uint32(BlueTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} purple trade goods", uint32(PurpleTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} orange trade goods", uint32(OrangeTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} yellow trade goods", uint32(YellowTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} grey   items"      , uint32(GreyItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} white  items"      , uint32(WhiteItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} green  items"      , uint32(GreenItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} blue   items"      , uint32(BlueItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} purple items"      , uint32(PurpleItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} orange items"      , uint32(OrangeItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} yellow items"      , uint32(YellowItemsBin.size()));
+    return ret;
 }
 
-std::set<uint32> AHBConfig::getCommaSeparatedIntegers(std::string text)
+std::vector<uint32> AHBConfig::getBundleWeights(std::string text)
 {
-    std::string       value;
-    std::stringstream stream;
-    std::set<uint32>  ret;
+    std::string         value;
+    std::stringstream   stream;
+    std::vector<uint32> ret;
+    uint32              total = 0;
 
     stream.str(text);
 
     //
-    // Continue to precess comma separated values
+    // A list that cannot be trusted disables the bundles altogether
     //
 
     while (std::getline(stream, value, ','))
     {
-        ret.insert(atoi(value.c_str()));
+        char const* begin = value.c_str();
+        char*       end   = NULL;
+
+        while (isspace(static_cast<unsigned char>(*begin)))
+        {
+            begin++;
+        }
+
+        unsigned long weight = strtoul(begin, &end, 10);
+
+        while (isspace(static_cast<unsigned char>(*end)))
+        {
+            end++;
+        }
+
+        if (*begin == '-' || end == begin || *end != '\0')
+        {
+            LOG_ERROR("module", "AHBot: AuctionHouseBot.BundleWeights has an invalid weight \"{}\", bundles disabled", value);
+            return std::vector<uint32>();
+        }
+
+        if (ret.size() == AHB_MAX_BUNDLE_STACKS)
+        {
+            LOG_ERROR("module", "AHBot: AuctionHouseBot.BundleWeights has more than {} weights, the rest is ignored", AHB_MAX_BUNDLE_STACKS);
+            break;
+        }
+
+        if (weight > AHB_MAX_BUNDLE_WEIGHT)
+        {
+            LOG_ERROR("module", "AHBot: AuctionHouseBot.BundleWeights weight {} reduced to {}", value, AHB_MAX_BUNDLE_WEIGHT);
+            weight = AHB_MAX_BUNDLE_WEIGHT;
+        }
+
+        ret.push_back(uint32(weight));
+        total += uint32(weight);
+    }
+
+    if (!ret.empty() && total == 0)
+    {
+        LOG_ERROR("module", "AHBot: AuctionHouseBot.BundleWeights are all zero, bundles disabled");
+        return std::vector<uint32>();
     }
 
     return ret;
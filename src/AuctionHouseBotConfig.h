@@ -21,11 +21,43 @@
 #define AUCTION_HOUSE_BOT_CONFIG_H
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "ObjectMgr.h"
 
+#include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotItemTable.h"
+#include "AuctionHouseBotPricing.h"
+#include "AuctionHouseBotSketch.h"
+#include "AuctionHouseBotStats.h"
+
+//
+// Limits of AuctionHouseBot.BundleWeights, keeping their total far from overflowing
+//
+
+#define AHB_MAX_BUNDLE_STACKS 100
+#define AHB_MAX_BUNDLE_WEIGHT 10000
+
+//
+// Market statistics of an item, as exported
+//
+
+struct AHBItemStatsRow
+{
+    uint32 item;
+    int32  random;
+    uint32 samples;
+    uint64 total;
+    uint64 price;
+    uint32 p25;
+    uint32 p50;
+    uint32 p75;
+};
+
 class AHBConfig
 {
 private:
@@ -144,17 +176,60 @@ private:
     uint32 yellowItems;
 
     // 
-    // Per-item statistics
+    // Per-item statistics, keyed by template and random property (see ItemStatsKey).
+    // The random property 0 holds the aggregate of all the variants of the template.
+    //
+
+    struct ItemStats
+    {
+        uint32            count;
+        uint64            sum;
+        uint64            price;
+        AHBQuantileSketch sketch;
+
+        ItemStats() : count(0), sum(0), price(0) { }
+    };
+
+    AHBItemTable<ItemStats> itemsStats;
+
+    //
+    // Statistics changed since the last flush to the database
+    //
+
+    std::set<uint64>         itemsDirty;
+
+    //
+    // Auctions owned by every bot in this house (bot id -> auction ids)
+    //
+
+    std::map<uint32, std::set<uint32>> botsAuctions;
+
+    //
+    // Pricing strategy of the house, rebuilt whenever the settings it depends on change
+    //
+
+    std::unique_ptr<AHBPricing> pricing;
+
+    //
+    // Full recounts of the house so far, and last buyer runs of the bots, from the checkpoint
     //
 
-    std::map<uint32, uint32> itemsCount;
-    std::map<uint32, uint64> itemsSum;
-    std::map<uint32, uint64> itemsPrice;
+    uint32                   checkpointEpoch;
+    std::map<uint32, uint32> checkpointRuns;
+
+    void             updateItemStats(uint64 key, uint32 perUnit, AHBRandom& random);
+    std::string      itemStatsStatement(uint32 maxItems, uint32& saved);
+    ItemStats const* findItemStats  (uint32 id, int32 randomPropertyId) const;
 
     void   InitializeFromFile();
     void   InitializeFromSql(std::set<uint32> botsIds);
+    bool   loadCheckpoint(std::set<uint32> const& botsIds);
+
+    uint32 scaleByPopulation(uint32 value);
 
-    std::set<uint32> getCommaSeparatedIntegers(std::string text);
+    std::set<uint32>    getCommaSeparatedIntegers(std::string text);
+    std::vector<uint32> getCommaSeparatedList    (std::string text);
+    std::vector<uint32> getBundleWeights         (std::string text);
 
 public:
     //
@@ -184,6 +259,41 @@ public:
     bool   SellMethod;
     bool   SellAtMarketPrice;
     uint32 MarketResetThreshold;
+    bool   MarketPersistence;
+    uint32 MarketFlushInterval;
+    uint32 MarketFlushBatch;
+    uint32 MarketSellQuantileMin;
+    uint32 MarketSellQuantileMax;
+    uint32 MarketBuyQuantile;
+    bool   MarketMergeHouses;
+    uint32 MarketVariantMinSamples;
+
+    std::string MetricsFile;
+    uint32      MetricsInterval;
+    std::string RecordFile;
+    bool        HookTimings;
+    uint32      LoadTestAccount;
+    uint32      LoadTestGUID;
+    uint32      LoadTestBidderGUID;
+    std::string ColumnarDirectory;
+    uint32      ColumnarInterval;
+    uint32      RandomSeed;
+    uint32      PricingStrategy;
+    bool        Checkpoint;
+    uint32      SweepInterval;
+    uint32      SweepRange;
+
+    std::vector<uint32> BundleWeights;          // Weight of listing 1, 2, 3... stacks of a stackable item together
+    bool                SharedSellPlan;         // Mirrored houses list what the first of them selected
+    AHBConfig*          SharedSellSource;       // House whose selling plan this one replays, set by AHBUpdateMirrors
+    uint32              SharedSellPerturbation; // Percentage the shared prices vary by in every house
+
+    bool        PopulationScaling;
+    uint32      PopulationFull;                 // Smoothed online players at which the full quotas apply
+    uint32      PopulationFloor;                // Lowest percentage of the quotas
+    uint32      PopulationCeiling;              // Highest percentage of the quotas
+    uint32      PopulationSmoothing;            // Weight of a new sample in the average, in percent
+
     bool   ConsiderOnlyBotAuctions;
     uint32 ItemsPerCycle;
 
@@ -287,6 +397,12 @@ public:
     std::set<uint32> OrangeItemsBin;
     std::set<uint32> YellowItemsBin;
 
+    //
+    // Timings and counters of all the bots operating on this house
+    //
+
+    AHBStats Stats;
+
     //
     // Constructors/destructors
     //
@@ -302,11 +418,19 @@ public:
 
     void   Initialize(std::set<uint32> botsIds);
     void   InitializeBins();
+    void   InitializeBins(ItemTemplateContainer const* its);
+    void   InitializeItemCounts(std::set<uint32> const& botsIds);
+    void   CountAuction(uint32 owner, uint32 auctionId, ItemTemplate const* prototype, std::set<uint32> const& botsIds);
+    void   InitializePricing();
     void   Reset();
 
     uint32 GetAHID();
     uint32 GetAHFID();
 
+    AHBPricing* GetPricing();
+
+    bool   IsMirrorOf        (AHBConfig* other);
+
     void   SetMinItems       (uint32 value);
     uint32 GetMinItems       ();
 
@@ -351,14 +475,50 @@ public:
     void   IncItemCounts     (uint32 color);
 
     void   ResetItemCounts   ();
+    void   SetItemCounts     (uint32 color, uint32 value);
     uint32 TotalItemCounts   ();
 
     uint32 GetItemCounts     (uint32 color);
 
-    void   UpdateItemStats   (uint32 id, uint32 stackSize, uint64 buyout);
-    uint64 GetItemPrice      (uint32 id);
+    void   UpdateItemStats   (uint32 id, int32 randomPropertyId, uint32 stackSize, uint64 buyout, AHBRandom& random);
+    uint64 GetItemPrice      (uint32 id, int32 randomPropertyId = 0);
+    uint64 GetItemQuantile   (uint32 id, int32 randomPropertyId, uint32 percent);
+
+    void   LoadItemStats     (uint32 id, int32 randomPropertyId, uint32 count, uint64 sum, std::vector<uint8> const& sketch);
+    uint32 SaveItemStats     (uint32 maxItems, bool all);
+    uint32 GetDirtyItemStats ();
+    uint32 GetItemStatsCount ();
+    void   GetItemStatsRows  (std::vector<AHBItemStatsRow>& rows);
+
+    void   AddBotAuction     (uint32 botId, uint32 auctionId);
+    void   RemoveBotAuction  (uint32 botId, uint32 auctionId);
+    uint32 ExpireBotAuctions (uint32 window);
+
+    void   SaveCheckpoint    (std::map<uint32, uint32> const& lastRuns);
+    uint32 GetCheckpointRun  (uint32 botId, uint32 fallback);
+
+    //
+    // Estimated memory of the lists, bins and indexes, in bytes
+    //
+
+    uint64 ReportMemory      (std::vector<std::string>& lines);
+
+    //
+    // Console commands
+    //
+
+    void   Commands          (AHBotCommand command, uint32 col, char* args);
 };
 
+//
+// Packs the template and the random property (negative for suffixes) in a single key
+//
+
+inline uint64 ItemStatsKey(uint32 id, int32 randomPropertyId)
+{
+    return (uint64(id) << 32) | uint32(randomPropertyId);
+}
+
 //
 // Globally defined configurations
 //
@@ -367,4 +527,10 @@ extern AHBConfig* gAllianceConfig;
 extern AHBConfig* gHordeConfig;
 extern AHBConfig* gNeutralConfig;
 
+//
+// Finds again which houses replay the selling plan of another, after their settings changed
+//
+
+void AHBUpdateMirrors();
+
 #endif // AUCTION_HOUSE_BOT_CONFIG_H
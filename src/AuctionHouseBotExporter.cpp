@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include "Log.h"
+#include "StringFormat.h"
+
+#include "AuctionHouseBot.h"
+#include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotExporter.h"
+#include "AuctionHouseBotPopulation.h"
+
+//
+// Names of the items classifications, in the AHB_GREY_TG ... AHB_YELLOW_I order
+//
+
+static char const* categoryNames[] =
+{
+    "grey_tg", "white_tg", "green_tg", "blue_tg", "purple_tg", "orange_tg", "yellow_tg",
+    "grey_i" , "white_i" , "green_i" , "blue_i" , "purple_i" , "orange_i" , "yellow_i"
+};
+
+AHBExporter::AHBExporter()
+{
+    _hasPending   = false;
+    _stop         = false;
+    _previousTime = 0;
+}
+
+AHBExporter::~AHBExporter()
+{
+    Stop();
+}
+
+void AHBExporter::Start(std::string const& path)
+{
+    Stop();
+
+    if (path.empty())
+    {
+        return;
+    }
+
+    _path       = path;
+    _stop       = false;
+    _hasPending = false;
+    _thread     = std::thread(&AHBExporter::run, this);
+}
+
+void AHBExporter::Stop()
+{
+    if (!_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+
+    _wakeup.notify_one();
+    _thread.join();
+}
+
+void AHBExporter::run()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+
+    while (true)
+    {
+        _wakeup.wait(guard, [this] { return _stop || _hasPending; });
+
+        if (_hasPending)
+        {
+            std::string text;
+
+            text.swap(_pending);
+            _hasPending = false;
+
+            //
+            // Do not hold the lock during the I/O, the world thread may be submitting
+            //
+
+            guard.unlock();
+            write(text);
+            guard.lock();
+        }
+
+        if (_stop)
+        {
+            return;
+        }
+    }
+}
+
+void AHBExporter::write(std::string const& text)
+{
+    std::string temp = _path + ".tmp";
+
+    {
+        std::ofstream file(temp, std::ios::out | std::ios::trunc);
+
+        if (!file)
+        {
+            LOG_ERROR("module", "AHBot: could not open the metrics file {}", temp);
+            return;
+        }
+
+        file << text;
+
+        if (!file)
+        {
+            LOG_ERROR("module", "AHBot: could not write the metrics file {}", temp);
+            return;
+        }
+    }
+
+    if (std::rename(temp.c_str(), _path.c_str()) != 0)
+    {
+        LOG_ERROR("module", "AHBot: could not rename the metrics file {} to {}", temp, _path);
+    }
+}
+
+uint64 AHBExporter::perMinute(uint32 key, uint64 value, uint64 elapsed)
+{
+    uint64 rate = 0;
+
+    if (elapsed && _previous.count(key) != 0 && value >= _previous[key])
+    {
+        rate = (value - _previous[key]) * MINUTE * IN_MILLISECONDS / elapsed;
+    }
+
+    _previous[key] = value;
+
+    return rate;
+}
+
+void AHBExporter::Collect()
+{
+    if (!Running())
+    {
+        return;
+    }
+
+    uint64 now     = uint64(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    uint64 elapsed = _previousTime ? now - _previousTime : 0;
+
+    _previousTime  = now;
+
+    AHBConfig* configs[] = { gAllianceConfig, gHordeConfig, gNeutralConfig };
+
+    std::string text;
+
+    //
+    // Auction house situation
+    //
+
+    text += "# HELP ahbot_auctions Auctions listed, by category\n";
+    text += "# TYPE ahbot_auctions gauge\n";
+
+    for (AHBConfig* config : configs)
+    {
+        for (uint32 category = AHB_GREY_TG; category <= AHB_YELLOW_I; ++category)
+        {
+            text += Acore::StringFormat("ahbot_auctions{{house=\"{}\",category=\"{}\"}} {}\n", config->GetAHID(), categoryNames[category], config->GetItemCounts(category));
+        }
+    }
+
+    text += "# HELP ahbot_quota Maximum number of auctions, by category\n";
+    text += "# TYPE ahbot_quota gauge\n";
+
+    for (AHBConfig* config : configs)
+    {
+        for (uint32 category = AHB_GREY_TG; category <= AHB_YELLOW_I; ++category)
+        {
+            text += Acore::StringFormat("ahbot_quota{{house=\"{}\",category=\"{}\"}} {}\n", config->GetAHID(), categoryNames[category], config->GetMaximum(category));
+        }
+    }
+
+    text += "# HELP ahbot_quota_scale Percentage of the configured quotas, following the online population\n";
+    text += "# TYPE ahbot_quota_scale gauge\n";
+    text += Acore::StringFormat("ahbot_quota_scale {}\n", gPopulation.GetScale());
+    text += "# HELP ahbot_players Players online at the last population sample\n";
+    text += "# TYPE ahbot_players gauge\n";
+    text += Acore::StringFormat("ahbot_players {}\n", gPopulation.GetPlayers());
+    text += "# HELP ahbot_players_average Smoothed online population the quotas follow\n";
+    text += "# TYPE ahbot_players_average gauge\n";
+    text += Acore::StringFormat("ahbot_players_average {:.1f}\n", gPopulation.GetAverage());
+
+    //
+    // Activity counters, and their rates since the previous collection
+    //
+
+    for (uint32 i = 0; i < AHB_COUNTER_MAX; ++i)
+    {
+        AHBCounter  counter = AHBCounter(i);
+        char const* name    = AHBStats::GetCounterName(counter);
+
+        text += Acore::StringFormat("# HELP ahbot_{}_total {}\n", name, AHBStats::GetCounterHelp(counter));
+        text += Acore::StringFormat("# TYPE ahbot_{}_total counter\n", name);
+
+        for (AHBConfig* config : configs)
+        {
+            text += Acore::StringFormat("ahbot_{}_total{{house=\"{}\"}} {}\n", name, config->GetAHID(), config->Stats.GetCounter(counter));
+        }
+    }
+
+    for (AHBCounter counter : { AHB_COUNTER_NO_SOLD, AHB_COUNTER_BIDS, AHB_COUNTER_BUYOUTS })
+    {
+        char const* name = AHBStats::GetCounterName(counter);
+
+        text += Acore::StringFormat("# HELP ahbot_{}_per_minute {}, per minute since the previous export\n", name, AHBStats::GetCounterHelp(counter));
+        text += Acore::StringFormat("# TYPE ahbot_{}_per_minute gauge\n", name);
+
+        for (AHBConfig* config : configs)
+        {
+            uint64 rate = perMinute(config->GetAHID() * AHB_COUNTER_MAX + counter, config->Stats.GetCounter(counter), elapsed);
+
+            text += Acore::StringFormat("ahbot_{}_per_minute{{house=\"{}\"}} {}\n", name, config->GetAHID(), rate);
+        }
+    }
+
+    //
+    // Database calls, by call site and kind
+    //
+
+    text += "# HELP ahbot_db_calls_total Database calls of the module\n";
+    text += "# TYPE ahbot_db_calls_total counter\n";
+
+    for (uint32 i = 0; i < AHB_DB_SITE_MAX; ++i)
+    {
+        for (uint32 j = 0; j < AHB_DB_KIND_MAX; ++j)
+        {
+            AHBDbSite site = AHBDbSite(i);
+            AHBDbKind kind = AHBDbKind(j);
+
+            text += Acore::StringFormat("ahbot_db_calls_total{{site=\"{}\",kind=\"{}\"}} {}\n", AHBDbStats::GetSiteName(site), AHBDbStats::GetKindName(kind), gDbStats.GetTotal(site, kind));
+        }
+    }
+
+    text += "# HELP ahbot_db_calls_last_cycle Database calls of the last update cycle\n";
+    text += "# TYPE ahbot_db_calls_last_cycle gauge\n";
+
+    for (uint32 i = 0; i < AHB_DB_SITE_MAX; ++i)
+    {
+        for (uint32 j = 0; j < AHB_DB_KIND_MAX; ++j)
+        {
+            AHBDbSite site = AHBDbSite(i);
+            AHBDbKind kind = AHBDbKind(j);
+
+            text += Acore::StringFormat("ahbot_db_calls_last_cycle{{site=\"{}\",kind=\"{}\"}} {}\n", AHBDbStats::GetSiteName(site), AHBDbStats::GetKindName(kind), gDbStats.GetLast(site, kind));
+        }
+    }
+
+    text += "# HELP ahbot_db_cycles_total Update cycles of the bots\n";
+    text += "# TYPE ahbot_db_cycles_total counter\n";
+    text += Acore::StringFormat("ahbot_db_cycles_total {}\n", gDbStats.GetCycles());
+
+    //
+    // Latencies, per house for every phase and per bot for the whole cycle
+    //
+
+    text += "# HELP ahbot_phase_seconds Duration of the phases of the update cycle\n";
+    text += "# TYPE ahbot_phase_seconds histogram\n";
+
+    auto histogram = [&text](AHBStats const& stats, AHBPhase phase, std::string const& labels)
+    {
+        uint64 cumulative = 0;
+
+        for (uint32 bucket = 0; bucket < AHB_STATS_BUCKETS; ++bucket)
+        {
+            cumulative += stats.GetBucket(phase, bucket);
+            text       += Acore::StringFormat("ahbot_phase_seconds_bucket{{{},le=\"{:.6f}\"}} {}\n", labels, AHBStats::GetBucketBound(bucket) / 1000000.0, cumulative);
+        }
+
+        cumulative += stats.GetBucket(phase, AHB_STATS_BUCKETS);
+
+        text += Acore::StringFormat("ahbot_phase_seconds_bucket{{{},le=\"+Inf\"}} {}\n", labels, cumulative);
+        text += Acore::StringFormat("ahbot_phase_seconds_sum{{{}}} {:.6f}\n", labels, stats.GetSum(phase) / 1000000.0);
+        text += Acore::StringFormat("ahbot_phase_seconds_count{{{}}} {}\n", labels, cumulative);
+    };
+
+    for (AHBConfig* config : configs)
+    {
+        for (uint32 i = 0; i < AHB_PHASE_MAX; ++i)
+        {
+            AHBPhase phase = AHBPhase(i);
+
+            if (config->Stats.GetCount(phase) != 0)
+            {
+                histogram(config->Stats, phase, Acore::StringFormat("house=\"{}\",phase=\"{}\"", config->GetAHID(), AHBStats::GetPhaseName(phase)));
+            }
+        }
+    }
+
+    for (AuctionHouseBot* bot : gBots)
+    {
+        histogram(bot->GetStats(), AHB_PHASE_CYCLE, Acore::StringFormat("bot=\"{}\",phase=\"{}\"", bot->GetAHBplayerGUID(), AHBStats::GetPhaseName(AHB_PHASE_CYCLE)));
+    }
+
+    //
+    // Hooks run with the players operations
+    //
+
+    text += "# HELP ahbot_hook_calls_total Calls of the auction and mail hooks\n";
+    text += "# TYPE ahbot_hook_calls_total counter\n";
+
+    for (uint32 i = 0; i < AHB_HOOK_MAX; ++i)
+    {
+        AHBHook hook = AHBHook(i);
+
+        text += Acore::StringFormat("ahbot_hook_calls_total{{hook=\"{}\"}} {}\n", AHBHookStats::GetHookName(hook), gHookStats.GetCalls(hook));
+    }
+
+    if (gHookStats.HasTimings())
+    {
+        text += "# HELP ahbot_hook_seconds Duration of the auction and mail hooks\n";
+        text += "# TYPE ahbot_hook_seconds histogram\n";
+
+        for (uint32 i = 0; i < AHB_HOOK_MAX; ++i)
+        {
+            AHBHook     hook       = AHBHook(i);
+            char const* name       = AHBHookStats::GetHookName(hook);
+            uint64      cumulative = 0;
+
+            for (uint32 bucket = 0; bucket < AHB_HOOK_BUCKETS; ++bucket)
+            {
+                cumulative += gHookStats.GetBucket(hook, bucket);
+                text       += Acore::StringFormat("ahbot_hook_seconds_bucket{{hook=\"{}\",le=\"{:.9f}\"}} {}\n", name, AHBHookStats::GetBucketBound(bucket) / 1000000000.0, cumulative);
+            }
+
+            cumulative += gHookStats.GetBucket(hook, AHB_HOOK_BUCKETS);
+
+            text += Acore::StringFormat("ahbot_hook_seconds_bucket{{hook=\"{}\",le=\"+Inf\"}} {}\n", name, cumulative);
+            text += Acore::StringFormat("ahbot_hook_seconds_sum{{hook=\"{}\"}} {:.9f}\n", name, gHookStats.GetSum(hook) / 1000000000.0);
+            text += Acore::StringFormat("ahbot_hook_seconds_count{{hook=\"{}\"}} {}\n", name, cumulative);
+        }
+    }
+
+    //
+    // Market statistics
+    //
+
+    text += "# HELP ahbot_market_entries Items with a known market price\n";
+    text += "# TYPE ahbot_market_entries gauge\n";
+
+    for (AHBConfig* config : configs)
+    {
+        text += Acore::StringFormat("ahbot_market_entries{{house=\"{}\"}} {}\n", config->GetAHID(), config->GetItemStatsCount());
+    }
+
+    text += "# HELP ahbot_market_dirty_entries Market prices waiting to be written to the database\n";
+    text += "# TYPE ahbot_market_dirty_entries gauge\n";
+
+    for (AHBConfig* config : configs)
+    {
+        text += Acore::StringFormat("ahbot_market_dirty_entries{{house=\"{}\"}} {}\n", config->GetAHID(), config->GetDirtyItemStats());
+    }
+
+    //
+    // Hand over to the writer; an older snapshot not yet written is simply replaced
+    //
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+
+        _pending    = std::move(text);
+        _hasPending = true;
+    }
+
+    _wakeup.notify_one();
+}
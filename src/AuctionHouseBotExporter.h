@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_EXPORTER_H
+#define AUCTION_HOUSE_BOT_EXPORTER_H
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Common.h"
+
+#include "AuctionHouseBotStats.h"
+
+class AHBConfig;
+
+// =============================================================================
+// Prometheus text format exporter (node_exporter textfile collector).
+//
+// The metrics are collected on the world thread, which owns all the data,
+// while the file is written by a dedicated thread: first to a temporary
+// file, then renamed over the target so a scrape never sees a partial file.
+// =============================================================================
+
+class AHBExporter
+{
+private:
+    std::string             _path;
+
+    std::thread             _thread;
+    std::mutex              _lock;
+    std::condition_variable _wakeup;
+    std::string             _pending;
+    bool                    _hasPending;
+    bool                    _stop;
+
+    //
+    // Counters seen at the previous collection, to compute the rates per minute
+    //
+
+    std::map<uint32, uint64> _previous;
+    uint64                   _previousTime;
+
+    void   run();
+    void   write(std::string const& text);
+
+    uint64 perMinute(uint32 key, uint64 value, uint64 elapsed);
+
+public:
+    AHBExporter();
+    ~AHBExporter();
+
+    void Start  (std::string const& path);
+    void Stop   ();
+    bool Running() const { return _thread.joinable(); };
+
+    void Collect();
+};
+
+#endif // AUCTION_HOUSE_BOT_EXPORTER_H
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include "Bag.h"
+#include "Item.h"
+#include "ItemTemplate.h"
+#include "ObjectMgr.h"
+
+#include "AuctionHouseBotItem.h"
+
+Item* AHBCreateItem(ItemTemplate const* prototype, uint32 count, int32 randomPropertyId, ObjectGuid owner)
+{
+    if (count < 1 || (prototype->GetMaxStackSize() > 0 && count > prototype->GetMaxStackSize()))
+    {
+        return NULL;
+    }
+
+    Item* item = NewItemOrBag(prototype);
+
+    if (!item->Create(sObjectMgr->GetGenerator<HighGuid::Item>().Generate(), prototype->ItemId, NULL))
+    {
+        delete item;
+        return NULL;
+    }
+
+    //
+    // No player to look up: the owner and the stack go straight into the fields
+    //
+
+    item->SetOwnerGUID(owner);
+    item->SetCount(count);
+
+    if (randomPropertyId != 0)
+    {
+        item->SetItemRandomProperties(randomPropertyId);
+    }
+
+    return item;
+}
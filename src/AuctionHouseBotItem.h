@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_ITEM_H
+#define AUCTION_HOUSE_BOT_ITEM_H
+
+#include "Common.h"
+#include "ObjectGuid.h"
+
+class  Item;
+struct ItemTemplate;
+
+// =============================================================================
+// Items of the bot auctions, built without any player: the owner is only a
+// guid and the item never enters an update queue, it goes from its creation
+// straight to the database and the auction manager, the way the core loads the
+// auction items at startup.
+// =============================================================================
+
+Item* AHBCreateItem(ItemTemplate const* prototype, uint32 count, int32 randomPropertyId, ObjectGuid owner);
+
+#endif // AUCTION_HOUSE_BOT_ITEM_H
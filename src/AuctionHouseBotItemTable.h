@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_ITEM_TABLE_H
+#define AUCTION_HOUSE_BOT_ITEM_TABLE_H
+
+#include <vector>
+
+#include "Common.h"
+
+#include "AuctionHouseBotMemory.h"
+
+// =============================================================================
+// Flat open addressing table keyed by ItemStatsKey (template in the high half,
+// random property in the low half).
+//
+// The slots only hold the key and the index of the value, the values are kept
+// dense in insertion order. The home slot depends on the template alone, so a
+// template and all its variants share one linear probe run: looking up a
+// variant with a fallback to the aggregate of its template is a single walk
+// over a few contiguous slots. Nothing is ever removed but by Clear.
+// =============================================================================
+
+template<class V>
+class AHBItemTable
+{
+private:
+    struct Slot
+    {
+        uint64 key;
+        uint32 index;
+    };
+
+    static constexpr uint64 EmptyKey = ~uint64(0);
+
+    std::vector<Slot>   _slots;
+    std::vector<uint64> _keys;
+    std::vector<V>      _values;
+    uint32              _bits;
+
+    uint32 home(uint64 key) const
+    {
+        return uint32(uint32(key >> 32) * 2654435769u) >> (32 - _bits);
+    }
+
+    void grow()
+    {
+        _bits = _bits ? _bits + 1 : 6;
+
+        _slots.assign(size_t(1) << _bits, Slot{ EmptyKey, 0 });
+
+        uint32 mask = uint32(_slots.size() - 1);
+
+        for (uint32 index = 0; index < _keys.size(); ++index)
+        {
+            uint32 slot = home(_keys[index]);
+
+            while (_slots[slot].key != EmptyKey)
+            {
+                slot = (slot + 1) & mask;
+            }
+
+            _slots[slot] = Slot{ _keys[index], index };
+        }
+    }
+
+public:
+    AHBItemTable() : _bits(0) { }
+
+    uint32   Size ()             const { return uint32(_values.size()); };
+    uint64   Key  (uint32 index) const { return _keys[index]; };
+    V const& Value(uint32 index) const { return _values[index]; };
+
+    void Clear()
+    {
+        _slots.clear();
+        _keys.clear();
+        _values.clear();
+        _bits = 0;
+    }
+
+    //
+    // Value of the key, default constructed when missing. The references do not survive an insertion.
+    //
+
+    V& operator[](uint64 key)
+    {
+        if ((_values.size() + 1) * 2 > _slots.size())
+        {
+            grow();
+        }
+
+        uint32 mask = uint32(_slots.size() - 1);
+        uint32 slot = home(key);
+
+        while (_slots[slot].key != EmptyKey)
+        {
+            if (_slots[slot].key == key)
+            {
+                return _values[_slots[slot].index];
+            }
+
+            slot = (slot + 1) & mask;
+        }
+
+        _slots[slot] = Slot{ key, uint32(_values.size()) };
+        _keys.push_back(key);
+        _values.emplace_back();
+
+        return _values.back();
+    }
+
+    //
+    // The variant if present and accepted, else the aggregate of the template, else NULL
+    //
+
+    template<class Accept>
+    V const* Find(uint64 variant, uint64 aggregate, Accept accept) const
+    {
+        if (_slots.empty())
+        {
+            return NULL;
+        }
+
+        uint32   mask  = uint32(_slots.size() - 1);
+        uint32   slot  = home(aggregate);
+        V const* found = NULL;
+
+        while (_slots[slot].key != EmptyKey)
+        {
+            if (_slots[slot].key == variant && accept(_values[_slots[slot].index]))
+            {
+                return &_values[_slots[slot].index];
+            }
+
+            if (_slots[slot].key == aggregate)
+            {
+                found = &_values[_slots[slot].index];
+
+                if (variant == aggregate)
+                {
+                    break;
+                }
+            }
+
+            slot = (slot + 1) & mask;
+        }
+
+        return found;
+    }
+
+    uint64 Memory() const
+    {
+        return AHBMemory(_slots) + AHBMemory(_keys) + AHBMemory(_values);
+    }
+};
+
+template<class V>
+inline uint64 AHBMemory(AHBItemTable<V> const& container)
+{
+    return container.Memory();
+}
+
+#endif // AUCTION_HOUSE_BOT_ITEM_TABLE_H
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include "Log.h"
+
+#include "AuctionHouseBotJob.h"
+
+AHBJob::AHBJob()
+{
+    _busy   = false;
+    _cancel = false;
+}
+
+AHBJob::~AHBJob()
+{
+    Stop();
+}
+
+bool AHBJob::Start(std::string const& name, Function function)
+{
+    if (_busy)
+    {
+        return false;
+    }
+
+    //
+    // The previous job is over, only its thread is left to collect
+    //
+
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+
+    _name   = name;
+    _busy   = true;
+    _cancel = false;
+    _thread = std::thread(&AHBJob::run, this, std::move(function));
+
+    return true;
+}
+
+void AHBJob::Stop()
+{
+    if (!_thread.joinable())
+    {
+        return;
+    }
+
+    //
+    // The tools check the flag between their stages
+    //
+
+    _cancel = true;
+    _thread.join();
+}
+
+void AHBJob::run(Function function)
+{
+    std::vector<std::string> lines;
+
+    function(lines);
+
+    LOG_INFO("module", "AHBot: {}{}", _name, _cancel ? " cancelled" : " done");
+
+    for (std::string const& line : lines)
+    {
+        LOG_INFO("module", "AHBot: {}", line);
+    }
+
+    _busy = false;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_JOB_H
+#define AUCTION_HOUSE_BOT_JOB_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common.h"
+
+// =============================================================================
+// Runs the offline tools of the module (benchmarks, replays) on a thread of
+// their own, one at a time. The world thread only prepares their input: the
+// tools work on copies and generated data and never touch the live houses.
+// Their report is written to the server log once they are done.
+// =============================================================================
+
+class AHBJob
+{
+public:
+    typedef std::function<void(std::vector<std::string>& lines)> Function;
+
+private:
+    std::thread       _thread;
+    std::atomic<bool> _busy;
+    std::atomic<bool> _cancel;
+    std::string       _name;
+
+    void run(Function function);
+
+public:
+    AHBJob();
+    ~AHBJob();
+
+    bool Start    (std::string const& name, Function function);
+    void Stop     ();
+    bool Busy     () const { return _busy; };
+    bool Cancelled() const { return _cancel; };
+
+    std::string const& GetName() const { return _name; };
+};
+
+extern AHBJob gJob;
+
+#endif // AUCTION_HOUSE_BOT_JOB_H
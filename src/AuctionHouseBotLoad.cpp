@@ -0,0 +1,512 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <algorithm>
+#include <functional>
+
+#include "AuctionHouseMgr.h"
+#include "CharacterCache.h"
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "Item.h"
+#include "Log.h"
+#include "ObjectMgr.h"
+#include "ScriptMgr.h"
+#include "StringFormat.h"
+
+#include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotItem.h"
+#include "AuctionHouseBotLoad.h"
+
+//
+// Indexes of the rates and of the done counters
+//
+
+enum AHBLoadAction
+{
+    AHB_LOAD_AUCTIONS,
+    AHB_LOAD_BIDS,
+    AHB_LOAD_BUYOUTS
+};
+
+AHBLoadGenerator::AHBLoadGenerator()
+{
+    _config = NULL;
+}
+
+bool AHBLoadGenerator::Start(AHBConfig* config, uint32 auctions, uint32 bids, uint32 buyouts, uint32 seconds, std::string& error)
+{
+    if (Running())
+    {
+        error = "a load test is already running";
+        return false;
+    }
+
+    //
+    // The test characters must exist, be two, belong to the test account and not be bots
+    //
+
+    if (!config->LoadTestAccount || !config->LoadTestGUID || !config->LoadTestBidderGUID)
+    {
+        error = "AuctionHouseBot.LoadTestAccount, AuctionHouseBot.LoadTestGUID and AuctionHouseBot.LoadTestBidderGUID are not set";
+        return false;
+    }
+
+    if (config->LoadTestGUID == config->LoadTestBidderGUID)
+    {
+        error = "the bidder must be another character than the seller";
+        return false;
+    }
+
+    for (uint32 guid : { config->LoadTestGUID, config->LoadTestBidderGUID })
+    {
+        if (sCharacterCache->GetCharacterAccountIdByGuid(ObjectGuid::Create<HighGuid::Player>(guid)) != config->LoadTestAccount)
+        {
+            error = Acore::StringFormat("character {} does not belong to account {}", guid, config->LoadTestAccount);
+            return false;
+        }
+
+        if (gBotsId.find(guid) != gBotsId.end())
+        {
+            error = Acore::StringFormat("character {} is an auction house bot", guid);
+            return false;
+        }
+    }
+
+    ObjectGuid owner = ObjectGuid::Create<HighGuid::Player>(config->LoadTestGUID);
+
+    //
+    // List what the bots of this house would list
+    //
+
+    _items.clear();
+
+    for (std::set<uint32> const* bin : { &config->GreyTradeGoodsBin, &config->WhiteTradeGoodsBin, &config->GreenTradeGoodsBin, &config->BlueTradeGoodsBin,
+                                         &config->PurpleTradeGoodsBin, &config->OrangeTradeGoodsBin, &config->YellowTradeGoodsBin,
+                                         &config->GreyItemsBin, &config->WhiteItemsBin, &config->GreenItemsBin, &config->BlueItemsBin,
+                                         &config->PurpleItemsBin, &config->OrangeItemsBin, &config->YellowItemsBin })
+    {
+        _items.insert(_items.end(), bin->begin(), bin->end());
+    }
+
+    if (_items.empty())
+    {
+        error = Acore::StringFormat("no items in the bins of auction house {}", config->GetAHID());
+        return false;
+    }
+
+    _config      = config;
+    _owner       = owner;
+    _bidder      = ObjectGuid::Create<HighGuid::Player>(config->LoadTestBidderGUID);
+    _auctions.clear();
+    _expiries.clear();
+
+    _rates[AHB_LOAD_AUCTIONS] = auctions;
+    _rates[AHB_LOAD_BIDS]     = bids;
+    _rates[AHB_LOAD_BUYOUTS]  = buyouts;
+
+    _done[AHB_LOAD_AUCTIONS]  = 0;
+    _done[AHB_LOAD_BIDS]      = 0;
+    _done[AHB_LOAD_BUYOUTS]   = 0;
+
+    _failed      = 0;
+    _duration    = seconds * IN_MILLISECONDS;
+    _elapsed     = 0;
+    _reportTimer = 0;
+
+    for (uint32 i = 0; i < AHB_HOOK_MAX; ++i)
+    {
+        AHBHook hook = AHBHook(i);
+
+        _hookCalls[i] = gHookStats.GetCalls(hook);
+        _hookTimed[i] = gHookStats.GetTimed(hook);
+        _hookSum[i]   = gHookStats.GetSum  (hook);
+    }
+
+    _cycleCount   = config->Stats.GetCount(AHB_PHASE_CYCLE);
+    _cycleSum     = config->Stats.GetSum  (AHB_PHASE_CYCLE);
+
+    _queueSum     = 0;
+    _queueSamples = 0;
+    _queueMax     = 0;
+
+    LOG_INFO("module", "AHBot: load test started on auction house {}: {} auctions, {} bids, {} buyouts per second for {}s",
+        config->GetAHID(), auctions, bids, buyouts, seconds);
+
+    return true;
+}
+
+void AHBLoadGenerator::Stop()
+{
+    if (!Running())
+    {
+        return;
+    }
+
+    std::vector<std::string> lines;
+
+    Report(lines);
+
+    for (std::string const& line : lines)
+    {
+        LOG_INFO("module", "AHBot: {}", line);
+    }
+
+    //
+    // Nothing generated is left for the core to settle
+    //
+
+    if (AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(_config->GetAHFID()))
+    {
+        for (uint32 id : _auctions)
+        {
+            if (AuctionEntry* auction = auctionHouse->GetAuction(id))
+            {
+                settle(auction, false);
+            }
+        }
+    }
+
+    _config = NULL;
+    _items.clear();
+    _auctions.clear();
+    _expiries.clear();
+}
+
+void AHBLoadGenerator::Update(uint32 diff)
+{
+    if (!Running())
+    {
+        return;
+    }
+
+    _elapsed = std::min(_elapsed + diff, _duration);
+
+    //
+    // Catch up with the rates since the start, so that long ticks do not lower them
+    //
+
+    for (uint32 action = AHB_LOAD_AUCTIONS; action <= AHB_LOAD_BUYOUTS; ++action)
+    {
+        uint32 target = uint32(uint64(_rates[action]) * _elapsed / IN_MILLISECONDS);
+
+        while (_done[action] < target)
+        {
+            bool performed = false;
+
+            switch (action)
+            {
+            case AHB_LOAD_AUCTIONS:
+                performed = list();
+                break;
+            case AHB_LOAD_BIDS:
+                performed = bid(false);
+                break;
+            case AHB_LOAD_BUYOUTS:
+                performed = bid(true);
+                break;
+            }
+
+            if (!performed)
+            {
+                _failed++;
+            }
+
+            _done[action]++;
+        }
+    }
+
+    //
+    // Expiries due, the auctions already bought out are gone
+    //
+
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(_config->GetAHFID());
+
+    while (!_expiries.empty() && _expiries.front().first <= _elapsed)
+    {
+        uint32 id = _expiries.front().second;
+
+        std::pop_heap(_expiries.begin(), _expiries.end(), std::greater<std::pair<uint32, uint32>>());
+        _expiries.pop_back();
+
+        if (AuctionEntry* auction = auctionHouse ? auctionHouse->GetAuction(id) : NULL)
+        {
+            settle(auction, false);
+        }
+    }
+
+    //
+    // Depth of the asynchronous queue of the characters database, where the auctions end up
+    //
+
+    uint32 depth = uint32(CharacterDatabase.QueueSize());
+
+    _queueSum += depth;
+    _queueSamples++;
+    _queueMax  = std::max(_queueMax, depth);
+
+    if (_elapsed >= _duration)
+    {
+        Stop();
+        return;
+    }
+
+    _reportTimer += diff;
+
+    if (_reportTimer >= AHB_LOAD_REPORT_INTERVAL * IN_MILLISECONDS)
+    {
+        _reportTimer = 0;
+
+        LOG_INFO("module", "AHBot: load test {}s/{}s, {} auctions, {} bids, {} buyouts, {} failed, database queue {}",
+            _elapsed / IN_MILLISECONDS, _duration / IN_MILLISECONDS, _done[AHB_LOAD_AUCTIONS], _done[AHB_LOAD_BIDS], _done[AHB_LOAD_BUYOUTS], _failed, depth);
+    }
+}
+
+bool AHBLoadGenerator::list()
+{
+    AuctionHouseObject*      auctionHouse = sAuctionMgr->GetAuctionsMap(_config->GetAHFID());
+    AuctionHouseEntry const* ahEntry      = sAuctionMgr->GetAuctionHouseEntry(_config->GetAHFID());
+
+    if (!auctionHouse || !ahEntry)
+    {
+        return false;
+    }
+
+    uint32              itemID    = _items[urand(0, _items.size() - 1)];
+    ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(itemID);
+
+    if (!prototype)
+    {
+        return false;
+    }
+
+    uint32 stackCount = prototype->GetMaxStackSize() > 1 ? urand(1, prototype->GetMaxStackSize()) : 1;
+    Item*  item       = AHBCreateItem(prototype, stackCount, 0, _owner);
+
+    if (!item)
+    {
+        return false;
+    }
+
+    //
+    // Prices around the vendor one, the way players tend to list
+    //
+
+    uint64 bidPrice    = std::max<uint64>(prototype->SellPrice, 100) * urand(2, 6) * stackCount;
+    uint64 buyoutPrice = bidPrice * urand(120, 200) / 100;
+    uint32 etime       = 12 * HOUR;
+
+    AuctionEntry* auctionEntry      = new AuctionEntry();
+    auctionEntry->Id                = sObjectMgr->GenerateAuctionID();
+    auctionEntry->houseId           = _config->GetAHID();
+    auctionEntry->item_guid         = item->GetGUID();
+    auctionEntry->item_template     = item->GetEntry();
+    auctionEntry->itemCount         = item->GetCount();
+    auctionEntry->owner             = _owner;
+    auctionEntry->startbid          = bidPrice;
+    auctionEntry->buyout            = buyoutPrice;
+    auctionEntry->bid               = 0;
+    auctionEntry->deposit           = sAuctionMgr->GetAuctionDeposit(ahEntry, etime, item, stackCount);
+    auctionEntry->auctionHouseEntry = ahEntry;
+
+    //
+    // Expire within the run, so the expiration hooks get their share of the load; the core
+    // would only see the auction after the end of the run, when it is gone already
+    //
+
+    auctionEntry->expire_time       = GameTime::GetGameTime().count() + (_duration - _elapsed) / IN_MILLISECONDS + HOUR;
+
+    auto trans = CharacterDatabase.BeginTransaction();
+
+    item->SaveToDB(trans);
+    sAuctionMgr->AddAItem(item);
+    auctionHouse->AddAuction(auctionEntry);
+    auctionEntry->SaveToDB(trans);
+
+    gDbStats.Count(AHB_DB_LOAD_TEST, AHB_DB_APPEND, uint32(trans->GetSize()));
+
+    CharacterDatabase.CommitTransaction(trans);
+    gDbStats.Count(AHB_DB_LOAD_TEST, AHB_DB_COMMIT);
+
+    _auctions.push_back(auctionEntry->Id);
+
+    _expiries.emplace_back(urand(_elapsed, _duration), auctionEntry->Id);
+    std::push_heap(_expiries.begin(), _expiries.end(), std::greater<std::pair<uint32, uint32>>());
+
+    return true;
+}
+
+bool AHBLoadGenerator::bid(bool buyout)
+{
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(_config->GetAHFID());
+
+    if (!auctionHouse)
+    {
+        return false;
+    }
+
+    //
+    // Pick one of the generated auctions, forgetting those which are gone
+    //
+
+    AuctionEntry* auction = NULL;
+
+    while (!auction && !_auctions.empty())
+    {
+        uint32 index = urand(0, _auctions.size() - 1);
+
+        auction = auctionHouse->GetAuction(_auctions[index]);
+
+        if (!auction)
+        {
+            _auctions[index] = _auctions.back();
+            _auctions.pop_back();
+        }
+    }
+
+    if (!auction)
+    {
+        return false;
+    }
+
+    if (buyout)
+    {
+        if (!auction->buyout)
+        {
+            return false;
+        }
+
+        auction->bidder = _bidder;
+        auction->bid    = auction->buyout;
+
+        settle(auction, true);
+
+        return true;
+    }
+
+    //
+    // Only the test bidder ever bids on these auctions, there is nobody to refund
+    //
+
+    uint32 price = auction->bid ? auction->bid + auction->GetAuctionOutBid() : auction->startbid;
+
+    if (auction->buyout && price >= auction->buyout)
+    {
+        return false;
+    }
+
+    auction->bidder = _bidder;
+    auction->bid    = price;
+
+    CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_AUCTION_BID);
+    stmt->SetData(0, auction->bidder.GetCounter());
+    stmt->SetData(1, auction->bid);
+    stmt->SetData(2, auction->Id);
+
+    CharacterDatabase.Execute(stmt);
+
+    gDbStats.Count(AHB_DB_LOAD_TEST, AHB_DB_ASYNC);
+
+    return true;
+}
+
+void AHBLoadGenerator::settle(AuctionEntry* auction, bool sold)
+{
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(_config->GetAHFID());
+
+    //
+    // The hooks the core would run, without its mails and payouts
+    //
+
+    if (sold)
+    {
+        sScriptMgr->OnAuctionSuccessful(auctionHouse, auction);
+    }
+    else
+    {
+        sScriptMgr->OnAuctionExpire(auctionHouse, auction);
+    }
+
+    //
+    // The auction and its item are deleted, nobody receives anything
+    //
+
+    Item* item = sAuctionMgr->GetAItem(auction->item_guid);
+
+    auto trans = CharacterDatabase.BeginTransaction();
+
+    Item::DeleteFromDB(trans, auction->item_guid.GetCounter());
+    auction->DeleteFromDB(trans);
+
+    gDbStats.Count(AHB_DB_LOAD_TEST, AHB_DB_APPEND, uint32(trans->GetSize()));
+
+    CharacterDatabase.CommitTransaction(trans);
+    gDbStats.Count(AHB_DB_LOAD_TEST, AHB_DB_COMMIT);
+
+    sAuctionMgr->RemoveAItem(auction->item_guid);
+    auctionHouse->RemoveAuction(auction);
+
+    delete item;
+}
+
+void AHBLoadGenerator::Report(std::vector<std::string>& lines) const
+{
+    if (!Running())
+    {
+        lines.push_back("No load test running");
+        return;
+    }
+
+    uint32 seconds = std::max<uint32>(_elapsed / IN_MILLISECONDS, 1);
+
+    lines.push_back(Acore::StringFormat("Load test on auction house {}, {}s/{}s:", _config->GetAHID(), _elapsed / IN_MILLISECONDS, _duration / IN_MILLISECONDS));
+    lines.push_back(Acore::StringFormat("  auctions={} ({}/s) bids={} ({}/s) buyouts={} ({}/s) failed={}",
+        _done[AHB_LOAD_AUCTIONS], _done[AHB_LOAD_AUCTIONS] / seconds,
+        _done[AHB_LOAD_BIDS]    , _done[AHB_LOAD_BIDS]     / seconds,
+        _done[AHB_LOAD_BUYOUTS] , _done[AHB_LOAD_BUYOUTS]  / seconds, _failed));
+
+    //
+    // Cost of the module hooks for the generated operations
+    //
+
+    for (uint32 i = 0; i < AHB_HOOK_MAX; ++i)
+    {
+        AHBHook hook  = AHBHook(i);
+        uint64  calls = gHookStats.GetCalls(hook) - _hookCalls[i];
+        uint64  timed = gHookStats.GetTimed(hook) - _hookTimed[i];
+        uint64  sum   = gHookStats.GetSum  (hook) - _hookSum[i];
+
+        if (calls == 0)
+        {
+            continue;
+        }
+
+        if (timed == 0)
+        {
+            lines.push_back(Acore::StringFormat("  hook {:<18} calls={} (timings disabled)", AHBHookStats::GetHookName(hook), calls));
+        }
+        else
+        {
+            lines.push_back(Acore::StringFormat("  hook {:<18} calls={} mean={}ns total={}us", AHBHookStats::GetHookName(hook), calls, sum / timed, sum / 1000));
+        }
+    }
+
+    //
+    // Sell and buy cycles of the bots on this house during the run
+    //
+
+    uint64 cycles = _config->Stats.GetCount(AHB_PHASE_CYCLE) - _cycleCount;
+    uint64 sum    = _config->Stats.GetSum  (AHB_PHASE_CYCLE) - _cycleSum;
+
+    uint32 p50;
+    uint32 p99;
+    uint32 max;
+
+    _config->Stats.GetTimings(AHB_PHASE_CYCLE, p50, p99, max);
+
+    lines.push_back(Acore::StringFormat("  bot cycles={} mean={}us (window p50={}us p99={}us max={}us)", cycles, cycles ? sum / cycles : 0, p50, p99, max));
+
+    lines.push_back(Acore::StringFormat("  database queue mean={} max={}", _queueSamples ? _queueSum / _queueSamples : 0, _queueMax));
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_LOAD_H
+#define AUCTION_HOUSE_BOT_LOAD_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common.h"
+#include "ObjectGuid.h"
+
+#include "AuctionHouseBotStats.h"
+
+class AHBConfig;
+struct AuctionEntry;
+
+#define AHB_LOAD_REPORT_INTERVAL 10 // Seconds between two progress reports in the log
+
+// =============================================================================
+// Synthetic player activity on an auction house, to load test a realm.
+//
+// Auctions, bids and buyouts are injected at fixed rates for a fixed duration
+// on behalf of two dedicated test characters, one listing and one bidding, so
+// that the module hooks run as they would in production.
+//
+// The trades are synthetic: nobody pays and nothing is mailed. Bought out
+// auctions, and those reaching the random expiry they get within the run, are
+// settled by the generator itself, which runs the auction hooks and deletes
+// the auction and its item; the core never settles them, they expire after the
+// end of the run. Whatever is left is deleted when the test stops.
+// Only driven from the world thread.
+// =============================================================================
+
+class AHBLoadGenerator
+{
+private:
+    AHBConfig*          _config;
+    ObjectGuid          _owner;
+    ObjectGuid          _bidder;
+    std::vector<uint32> _items;                  // Templates to list, from the bins of the house
+    std::vector<uint32> _auctions;               // Generated auctions, possibly gone already
+
+    std::vector<std::pair<uint32, uint32>> _expiries; // Min heap of the run time, in ms, at which each auction expires
+
+    uint32              _rates[3];               // Per second: auctions, bids, buyouts
+    uint32              _done[3];
+    uint32              _failed;
+    uint32              _duration;               // Milliseconds
+    uint32              _elapsed;
+    uint32              _reportTimer;
+
+    //
+    // Counters at the start of the run, the report shows the difference
+    //
+
+    uint64              _hookCalls[AHB_HOOK_MAX];
+    uint64              _hookTimed[AHB_HOOK_MAX];
+    uint64              _hookSum[AHB_HOOK_MAX];
+    uint64              _cycleCount;
+    uint64              _cycleSum;
+
+    uint64              _queueSum;
+    uint32              _queueSamples;
+    uint32              _queueMax;
+
+    bool   list  ();
+    bool   bid   (bool buyout);
+    void   settle(AuctionEntry* auction, bool sold);
+
+public:
+    AHBLoadGenerator();
+
+    bool Start  (AHBConfig* config, uint32 auctions, uint32 bids, uint32 buyouts, uint32 seconds, std::string& error);
+    void Stop   ();
+    bool Running() const { return _config != NULL; };
+
+    bool IsTestOwner(ObjectGuid guid) const { return Running() && guid == _owner; };
+
+    uint64 GetMemory() const { return (_items.capacity() + _auctions.capacity()) * sizeof(uint32) + _expiries.capacity() * sizeof(std::pair<uint32, uint32>); };
+
+    void Update (uint32 diff);
+    void Report (std::vector<std::string>& lines) const;
+};
+
+extern AHBLoadGenerator gLoadGenerator;
+
+#endif // AUCTION_HOUSE_BOT_LOAD_H
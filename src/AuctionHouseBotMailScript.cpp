@@ -21,6 +21,8 @@ void AHBot_MailScript::OnBeforeMailDraftSendMailTo(
     bool& deleteMailItemsFromDB,
     bool& sendMail)
 {
+    AHBHookTimer timer(AHB_HOOK_MAIL_SEND);
+
     //
     // If the mail is for the bot, then remove it and delete the items bought
     //
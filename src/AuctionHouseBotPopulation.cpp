@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <algorithm>
+
+#include "Log.h"
+#include "World.h"
+
+#include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotPopulation.h"
+
+AHBPopulation::AHBPopulation()
+{
+    _timer   = 0;
+    _samples = 0;
+    _players = 0;
+    _average = 0;
+    _scale   = 100;
+}
+
+void AHBPopulation::Update(uint32 diff)
+{
+    if (!gAllianceConfig->PopulationScaling)
+    {
+        _scale = 100;
+        return;
+    }
+
+    _timer += diff;
+
+    //
+    // Between two samples the scale still follows a reload of the settings
+    //
+
+    if (_samples && _timer < AHB_POPULATION_INTERVAL * IN_MILLISECONDS)
+    {
+        _scale = computeScale();
+        return;
+    }
+
+    _timer   = 0;
+    _players = sWorld->GetPlayerCount();
+
+    //
+    // The first sample is taken as is, the next ones move the average by PopulationSmoothing percent
+    //
+
+    if (_samples++ == 0)
+    {
+        _average = _players;
+    }
+    else
+    {
+        double weight = std::min<uint32>(std::max<uint32>(gAllianceConfig->PopulationSmoothing, 1), 100) / 100.0;
+
+        _average += (_players - _average) * weight;
+    }
+
+    _scale = computeScale();
+
+    if (gAllianceConfig->DebugOutConfig)
+    {
+        LOG_INFO("module", "AHBot: {} players online, {:.1f} on average, quotas at {}%", _players, _average, GetScale());
+    }
+}
+
+uint32 AHBPopulation::computeScale() const
+{
+    uint32 floor   = gAllianceConfig->PopulationFloor;
+    uint32 ceiling = std::max(gAllianceConfig->PopulationCeiling, floor);
+
+    if (gAllianceConfig->PopulationFull == 0)
+    {
+        return ceiling;
+    }
+
+    //
+    // Linear in the smoothed population, the full quotas at PopulationFull players
+    //
+
+    uint32 scale = uint32(_average * 100 / gAllianceConfig->PopulationFull);
+
+    return std::min(std::max(scale, floor), ceiling);
+}
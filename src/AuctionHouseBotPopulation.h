@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_POPULATION_H
+#define AUCTION_HOUSE_BOT_POPULATION_H
+
+#include <atomic>
+
+#include "Common.h"
+
+//
+// Seconds between two samples of the online players
+//
+
+#define AHB_POPULATION_INTERVAL 60
+
+// =============================================================================
+// Online population seen by the bots, smoothed with an exponential moving
+// average so a burst of logins or a disconnection wave does not make the
+// quotas of the houses jump. Sampled from the world thread only; the scale it
+// yields is published atomically, the background tools may read it anytime.
+// =============================================================================
+
+class AHBPopulation
+{
+private:
+    uint32 _timer;
+    uint32 _samples;
+    uint32 _players;                             // Last sample
+    double _average;                             // Smoothed number of players
+
+    std::atomic<uint32> _scale;                  // Percentage of the quotas, as of the last sample
+
+    uint32 computeScale() const;
+
+public:
+    AHBPopulation();
+
+    void   Update(uint32 diff);
+
+    uint32 GetPlayers() const { return _players; };
+    double GetAverage() const { return _average; };
+
+    //
+    // Percentage of the configured quotas the houses maintain right now
+    //
+
+    uint32 GetScale() const { return _scale; };
+};
+
+extern AHBPopulation gPopulation;
+
+#endif // AUCTION_HOUSE_BOT_POPULATION_H
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <algorithm>
+#include <string>
+
+#include "ItemTemplate.h"
+
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotPricing.h"
+#include "AuctionHouseBotRandom.h"
+
+// =============================================================================
+// Seller policies: unit buyout of a new auction
+// =============================================================================
+
+template<bool UseBuyPrice>
+struct AHBVendorSell
+{
+    static constexpr char const* Name   = "vendor";
+    static constexpr bool        Market = false;
+
+    static uint64 Price(AHBConfig* /*config*/, ItemTemplate const* prototype, int32 /*randomPropertyId*/, AHBRandom& /*random*/)
+    {
+        return UseBuyPrice ? prototype->BuyPrice : prototype->SellPrice;
+    }
+};
+
+//
+// Average price paid on the market, the vendor price when never seen
+//
+
+template<bool UseBuyPrice>
+struct AHBMarketSell
+{
+    static constexpr char const* Name   = "market";
+    static constexpr bool        Market = true;
+
+    static uint64 Price(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, AHBRandom& random)
+    {
+        uint64 price = config->GetItemPrice(prototype->ItemId, randomPropertyId);
+
+        return price ? price : AHBVendorSell<UseBuyPrice>::Price(config, prototype, randomPropertyId, random);
+    }
+};
+
+//
+// Random quantile of the market prices between MarketSellQuantileMin and Max
+//
+
+template<bool UseBuyPrice>
+struct AHBQuantileSell
+{
+    static constexpr char const* Name   = "quantile";
+    static constexpr bool        Market = true;
+
+    static uint64 Price(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, AHBRandom& random)
+    {
+        uint64 price = config->GetItemQuantile(prototype->ItemId, randomPropertyId, random.Range(config->MarketSellQuantileMin, config->MarketSellQuantileMax));
+
+        return price ? price : AHBVendorSell<UseBuyPrice>::Price(config, prototype, randomPropertyId, random);
+    }
+};
+
+//
+// Market quantile, but never below what a vendor gives for the item
+//
+
+template<bool UseBuyPrice>
+struct AHBHybridSell
+{
+    static constexpr char const* Name   = "hybrid";
+    static constexpr bool        Market = true;
+
+    static uint64 Price(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, AHBRandom& random)
+    {
+        uint64 price = config->GetItemQuantile(prototype->ItemId, randomPropertyId, random.Range(config->MarketSellQuantileMin, config->MarketSellQuantileMax));
+
+        if (price == 0)
+        {
+            return AHBVendorSell<UseBuyPrice>::Price(config, prototype, randomPropertyId, random);
+        }
+
+        return std::max<uint64>(price, prototype->SellPrice);
+    }
+};
+
+// =============================================================================
+// Buyer policies: highest bid on the whole stack
+// =============================================================================
+
+//
+// Vendor price times the buyer percentage of the quality
+//
+
+template<bool UseSellPrice>
+struct AHBVendorBuy
+{
+    static constexpr char const* Name = "vendor";
+
+    static long double BidMax(AHBConfig* config, ItemTemplate const* prototype, int32 /*randomPropertyId*/, uint32 itemCount, uint32 currentprice)
+    {
+        uint64 vendorPrice = UseSellPrice ? prototype->SellPrice : prototype->BuyPrice;
+        uint64 bidMax      = vendorPrice * itemCount * config->GetBuyerPrice(prototype->Quality);
+
+        return currentprice < bidMax ? bidMax : 0;
+    }
+};
+
+//
+// Average market price, the vendor rule when never seen
+//
+
+template<bool UseSellPrice>
+struct AHBMarketBuy
+{
+    static constexpr char const* Name = "market";
+
+    static long double BidMax(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, uint32 itemCount, uint32 currentprice)
+    {
+        uint64 marketPrice = config->GetItemPrice(prototype->ItemId, randomPropertyId);
+
+        if (marketPrice == 0)
+        {
+            return AHBVendorBuy<UseSellPrice>::BidMax(config, prototype, randomPropertyId, itemCount, currentprice);
+        }
+
+        return currentprice < marketPrice * itemCount ? marketPrice * itemCount : 0;
+    }
+};
+
+//
+// MarketBuyQuantile of the market prices, the vendor rule when never seen or when it is 0
+//
+
+template<bool UseSellPrice>
+struct AHBQuantileBuy
+{
+    static constexpr char const* Name = "quantile";
+
+    static long double BidMax(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, uint32 itemCount, uint32 currentprice)
+    {
+        uint64 marketPrice = config->MarketBuyQuantile ? config->GetItemQuantile(prototype->ItemId, randomPropertyId, config->MarketBuyQuantile) : 0;
+
+        if (marketPrice == 0)
+        {
+            return AHBVendorBuy<UseSellPrice>::BidMax(config, prototype, randomPropertyId, itemCount, currentprice);
+        }
+
+        return currentprice < marketPrice * itemCount ? marketPrice * itemCount : 0;
+    }
+};
+
+//
+// Vendor rule, never above MarketBuyQuantile of the market prices
+//
+
+template<bool UseSellPrice>
+struct AHBHybridBuy
+{
+    static constexpr char const* Name = "hybrid";
+
+    static long double BidMax(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, uint32 itemCount, uint32 currentprice)
+    {
+        long double bidMax = AHBVendorBuy<UseSellPrice>::BidMax(config, prototype, randomPropertyId, itemCount, currentprice);
+
+        if (bidMax == 0)
+        {
+            return 0;
+        }
+
+        uint64 marketPrice = config->MarketBuyQuantile ? config->GetItemQuantile(prototype->ItemId, randomPropertyId, config->MarketBuyQuantile) : 0;
+
+        if (marketPrice && bidMax > marketPrice * itemCount)
+        {
+            bidMax = marketPrice * itemCount;
+        }
+
+        return currentprice < bidMax ? bidMax : 0;
+    }
+};
+
+// =============================================================================
+// Strategy: a seller and a buyer policy behind the common interface
+// =============================================================================
+
+template<class SellPolicy, class BuyPolicy>
+class AHBPricingStrategy : public AHBPricing
+{
+private:
+    std::string _name;
+
+public:
+    AHBPricingStrategy() : _name(std::string(SellPolicy::Name) + "/" + BuyPolicy::Name) { };
+
+    char const* GetName() const override
+    {
+        return _name.c_str();
+    }
+
+    bool IsMarketSell() const override
+    {
+        return SellPolicy::Market;
+    }
+
+    uint64 GetSellPrice(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, AHBRandom& random) const override
+    {
+        return SellPolicy::Price(config, prototype, randomPropertyId, random);
+    }
+
+    long double GetBidMax(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, uint32 itemCount, uint32 currentprice) const override
+    {
+        return BuyPolicy::BidMax(config, prototype, randomPropertyId, itemCount, currentprice);
+    }
+};
+
+//
+// Resolve the flags into template arguments, one level at a time
+//
+
+template<class SellPolicy, template<bool> class BuyPolicy>
+static AHBPricing* createPricing(bool useSellPrice)
+{
+    if (useSellPrice)
+    {
+        return new AHBPricingStrategy<SellPolicy, BuyPolicy<true>>();
+    }
+
+    return new AHBPricingStrategy<SellPolicy, BuyPolicy<false>>();
+}
+
+template<class SellPolicy>
+static AHBPricing* createPricing(uint32 buy, bool useSellPrice)
+{
+    switch (buy)
+    {
+    case AHB_PRICING_MARKET:
+        return createPricing<SellPolicy, AHBMarketBuy>  (useSellPrice);
+    case AHB_PRICING_QUANTILE:
+        return createPricing<SellPolicy, AHBQuantileBuy>(useSellPrice);
+    case AHB_PRICING_HYBRID:
+        return createPricing<SellPolicy, AHBHybridBuy>  (useSellPrice);
+    default:
+        return createPricing<SellPolicy, AHBVendorBuy>  (useSellPrice);
+    }
+}
+
+template<template<bool> class SellPolicy>
+static AHBPricing* createPricing(bool useBuyPrice, uint32 buy, bool useSellPrice)
+{
+    if (useBuyPrice)
+    {
+        return createPricing<SellPolicy<true>>(buy, useSellPrice);
+    }
+
+    return createPricing<SellPolicy<false>>(buy, useSellPrice);
+}
+
+AHBPricing* AHBCreatePricing(AHBConfig* config)
+{
+    uint32 sell = config->PricingStrategy;
+    uint32 buy  = config->PricingStrategy;
+
+    //
+    // Without an explicit strategy, keep the behavior of the historical flags
+    //
+
+    if (sell == AHB_PRICING_AUTO || sell >= AHB_PRICING_MAX)
+    {
+        sell = config->SellAtMarketPrice ? AHB_PRICING_QUANTILE : AHB_PRICING_VENDOR;
+        buy  = config->MarketBuyQuantile ? AHB_PRICING_HYBRID   : AHB_PRICING_VENDOR;
+    }
+
+    //
+    // UseBuyPriceForSeller picks BuyPrice, UseBuyPriceForBuyer picks SellPrice
+    //
+
+    bool useBuyPrice  = config->SellMethod;
+    bool useSellPrice = config->BuyMethod;
+
+    switch (sell)
+    {
+    case AHB_PRICING_MARKET:
+        return createPricing<AHBMarketSell>  (useBuyPrice, buy, useSellPrice);
+    case AHB_PRICING_QUANTILE:
+        return createPricing<AHBQuantileSell>(useBuyPrice, buy, useSellPrice);
+    case AHB_PRICING_HYBRID:
+        return createPricing<AHBHybridSell>  (useBuyPrice, buy, useSellPrice);
+    default:
+        return createPricing<AHBVendorSell>  (useBuyPrice, buy, useSellPrice);
+    }
+}
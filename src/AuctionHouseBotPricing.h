@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_PRICING_H
+#define AUCTION_HOUSE_BOT_PRICING_H
+
+#include "Common.h"
+
+class  AHBConfig;
+class  AHBRandom;
+struct ItemTemplate;
+
+//
+// Values of AuctionHouseBot.PricingStrategy
+//
+
+enum AHBPricingKind
+{
+    AHB_PRICING_AUTO     = 0,    // Derived from UseMarketPriceForSeller and MarketBuyQuantile
+    AHB_PRICING_VENDOR   = 1,
+    AHB_PRICING_MARKET   = 2,
+    AHB_PRICING_QUANTILE = 3,
+    AHB_PRICING_HYBRID   = 4,
+    AHB_PRICING_MAX
+};
+
+// =============================================================================
+// How the seller prices its auctions and how far the buyer is ready to go.
+//
+// Every strategy is a template instantiation over a seller and a buyer policy,
+// with the vendor price fields baked in, built once per house when its
+// configuration is loaded. The inner loops make a single indirect call per
+// item and never test the configuration flags. A new strategy is a new policy
+// and a new case in AHBCreatePricing, the bodies of Sell and Buy do not change.
+// =============================================================================
+
+class AHBPricing
+{
+public:
+    virtual ~AHBPricing() { };
+
+    virtual char const* GetName() const = 0;
+
+    //
+    // Whether the sell price depends on the market statistics of the house
+    //
+
+    virtual bool        IsMarketSell() const = 0;
+
+    //
+    // Unit buyout before the seller percentages of the quality are applied
+    //
+
+    virtual uint64      GetSellPrice(AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, AHBRandom& random) const = 0;
+
+    //
+    // Most the buyer pays for the whole stack, 0 if it does not bid
+    //
+
+    virtual long double GetBidMax   (AHBConfig* config, ItemTemplate const* prototype, int32 randomPropertyId, uint32 itemCount, uint32 currentprice) const = 0;
+};
+
+AHBPricing* AHBCreatePricing(AHBConfig* config);
+
+#endif // AUCTION_HOUSE_BOT_PRICING_H
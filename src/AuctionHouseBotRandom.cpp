@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <random>
+
+#include "AuctionHouseBotRandom.h"
+
+AHBRandom::AHBRandom()
+{
+    std::random_device device;
+
+    Seed((uint64(device()) << 32) | device());
+}
+
+void AHBRandom::Seed(uint64 seed)
+{
+    //
+    // Expand the seed with splitmix64, so that close seeds give unrelated streams
+    // and the state is never all zeros
+    //
+
+    for (uint32 i = 0; i < 4; i += 2)
+    {
+        uint64 z = (seed += 0x9E3779B97F4A7C15ULL);
+
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z =  z ^ (z >> 31);
+
+        _state[i]     = uint32(z);
+        _state[i + 1] = uint32(z >> 32);
+    }
+
+    //
+    // Drop whatever was buffered from the previous seed
+    //
+
+    _next = AHB_RANDOM_BATCH;
+}
+
+void AHBRandom::Fill(uint32* values, uint32 count)
+{
+    for (uint32 i = 0; i < count; ++i)
+    {
+        values[i] = step();
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_RANDOM_H
+#define AUCTION_HOUSE_BOT_RANDOM_H
+
+#include "Common.h"
+
+#define AHB_RANDOM_BATCH 64
+
+// =============================================================================
+// Small and fast pseudo random stream (xoshiro128**), one for every bot.
+//
+// The state is 16 bytes and is not shared, so the bots never contend on the
+// core generator and a fixed seed replays the same decisions. The numbers are
+// generated AHB_RANDOM_BATCH at a time into a buffer that the draws consume;
+// Fill generates any amount at once for the callers that know how many they
+// need. Not meant for anything security related.
+// =============================================================================
+
+class AHBRandom
+{
+private:
+    uint32 _state[4];
+    uint32 _buffer[AHB_RANDOM_BATCH];
+    uint32 _next;
+
+    static uint32 rotl(uint32 x, int k) { return (x << k) | (x >> (32 - k)); };
+
+    uint32 step()
+    {
+        uint32 result = rotl(_state[1] * 5, 7) * 9;
+        uint32 t      = _state[1] << 9;
+
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3]  = rotl(_state[3], 11);
+
+        return result;
+    };
+
+public:
+    AHBRandom();
+
+    void   Seed(uint64 seed);
+    void   Fill(uint32* values, uint32 count);
+
+    uint32 Next()
+    {
+        if (_next == AHB_RANDOM_BATCH)
+        {
+            Fill(_buffer, AHB_RANDOM_BATCH);
+            _next = 0;
+        }
+
+        return _buffer[_next++];
+    };
+
+    //
+    // Uniform in [min, max], both included, without modulo bias (Lemire)
+    //
+
+    uint32 Range(uint32 min, uint32 max)
+    {
+        if (max <= min)
+        {
+            return min;
+        }
+
+        uint32 span = max - min + 1;
+
+        if (span == 0)
+        {
+            return Next();
+        }
+
+        uint64 product = uint64(Next()) * span;
+
+        if (uint32(product) < span)
+        {
+            uint32 threshold = uint32(-span) % span;
+
+            while (uint32(product) < threshold)
+            {
+                product = uint64(Next()) * span;
+            }
+        }
+
+        return min + uint32(product >> 32);
+    };
+};
+
+//
+// Stream of the market statistics learned from the live auctions
+//
+
+extern AHBRandom gMarketRandom;
+
+#endif // AUCTION_HOUSE_BOT_RANDOM_H
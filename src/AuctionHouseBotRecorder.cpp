@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <cstring>
+
+#include "GameTime.h"
+#include "Log.h"
+
+#include "AuctionHouseBotRecorder.h"
+
+//
+// Header of the file, changed whenever the record layout changes
+//
+
+static char const recordMagic[8] = { 'A', 'H', 'B', 'R', 'E', 'C', '0', '2' };
+
+AHBRecorder::AHBRecorder()
+{
+    _file    = NULL;
+    _stop    = false;
+    _failed  = false;
+    _dropped = 0;
+}
+
+AHBRecorder::~AHBRecorder()
+{
+    Stop();
+}
+
+void AHBRecorder::Start(std::string const& path)
+{
+    Stop();
+
+    if (path.empty())
+    {
+        return;
+    }
+
+    _file = fopen(path.c_str(), "ab");
+
+    if (!_file)
+    {
+        LOG_ERROR("module", "AHBot: could not open the record file {}", path);
+        return;
+    }
+
+    //
+    // A new file starts with the header, an existing one is appended to
+    //
+
+    if (ftell(_file) == 0)
+    {
+        fwrite(recordMagic, sizeof(recordMagic), 1, _file);
+    }
+
+    _buffer.reserve(AHB_RECORD_BUFFER);
+
+    _stop    = false;
+    _failed  = false;
+    _dropped = 0;
+    _thread  = std::thread(&AHBRecorder::run, this);
+}
+
+void AHBRecorder::Stop()
+{
+    if (!_thread.joinable())
+    {
+        return;
+    }
+
+    //
+    // The buffers already handed over are still written
+    //
+
+    Flush();
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stop = true;
+    }
+
+    _wakeup.notify_one();
+    _thread.join();
+
+    fclose(_file);
+    _file = NULL;
+
+    if (_dropped)
+    {
+        LOG_ERROR("module", "AHBot: {} records dropped, the record file could not keep up", _dropped);
+    }
+}
+
+void AHBRecorder::run()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+
+    while (true)
+    {
+        _wakeup.wait(guard, [this] { return _stop || !_pending.empty(); });
+
+        while (!_pending.empty())
+        {
+            std::vector<AHBRecord> records = std::move(_pending.front());
+
+            _pending.erase(_pending.begin());
+
+            //
+            // Do not hold the lock during the I/O, the world thread may be handing over
+            //
+
+            guard.unlock();
+
+            if (!_failed && fwrite(records.data(), sizeof(AHBRecord), records.size(), _file) != records.size())
+            {
+                LOG_ERROR("module", "AHBot: could not write {} records, recording stopped", records.size());
+
+                _failed = true;
+            }
+
+            guard.lock();
+        }
+
+        if (_stop)
+        {
+            return;
+        }
+    }
+}
+
+void AHBRecorder::Record(AHBRecordEvent event, uint32 house, uint32 item, int32 random, uint32 count, uint64 price, uint32 current, uint32 outBid)
+{
+    if (!Running())
+    {
+        return;
+    }
+
+    AHBRecord record = { };
+
+    record.time    = uint32(GameTime::GetGameTime().count());
+    record.event   = event;
+    record.house   = house;
+    record.count   = count;
+    record.price   = price;
+    record.item    = item;
+    record.random  = random;
+    record.current = current;
+    record.outBid  = outBid;
+
+    _buffer.push_back(record);
+
+    if (_buffer.size() >= AHB_RECORD_BUFFER)
+    {
+        Flush();
+    }
+}
+
+void AHBRecorder::Flush()
+{
+    if (!_thread.joinable() || _buffer.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+
+        if (_pending.size() < AHB_RECORD_PENDING)
+        {
+            _pending.push_back(std::move(_buffer));
+        }
+        else
+        {
+            _dropped += _buffer.size();
+        }
+    }
+
+    _wakeup.notify_one();
+
+    _buffer.clear();
+    _buffer.reserve(AHB_RECORD_BUFFER);
+}
+
+uint64 AHBRecorder::GetMemory() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    uint64 memory = _buffer.capacity() * sizeof(AHBRecord);
+
+    for (std::vector<AHBRecord> const& records : _pending)
+    {
+        memory += records.capacity() * sizeof(AHBRecord);
+    }
+
+    return memory;
+}
+
+bool AHBRecorder::Load(std::string const& path, std::vector<AHBRecord>& records)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+
+    if (!file)
+    {
+        return false;
+    }
+
+    char magic[sizeof(recordMagic)];
+
+    if (fread(magic, sizeof(magic), 1, file) != 1 || memcmp(magic, recordMagic, sizeof(magic)) != 0)
+    {
+        fclose(file);
+        return false;
+    }
+
+    AHBRecord record;
+
+    while (fread(&record, sizeof(record), 1, file) == 1)
+    {
+        records.push_back(record);
+    }
+
+    fclose(file);
+
+    return true;
+}
+
+char const* AHBRecorder::GetEventName(uint8 event)
+{
+    switch (event)
+    {
+    case AHB_RECORD_ADD:
+        return "add";
+    case AHB_RECORD_REMOVE:
+        return "remove";
+    case AHB_RECORD_SUCCESSFUL:
+        return "successful";
+    case AHB_RECORD_EXPIRE:
+        return "expire";
+    case AHB_RECORD_LISTING:
+        return "listing";
+    case AHB_RECORD_BID:
+        return "bid";
+    case AHB_RECORD_BUYOUT:
+        return "buyout";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_RECORDER_H
+#define AUCTION_HOUSE_BOT_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common.h"
+
+#define AHB_RECORD_BUFFER  512
+#define AHB_RECORD_PENDING 64
+
+//
+// Recorded events
+//
+
+enum AHBRecordEvent : uint8
+{
+    AHB_RECORD_ADD,            // Any auction listed: item, count, buyout
+    AHB_RECORD_REMOVE,         // Any auction removed: item, count
+    AHB_RECORD_SUCCESSFUL,     // Auction won: item, count, buyout
+    AHB_RECORD_EXPIRE,         // Auction expired: item, count, bid
+    AHB_RECORD_LISTING,        // Bot listing: item, count, buyout
+    AHB_RECORD_BID,            // Bot bid: item, count, bid, current, outbid
+    AHB_RECORD_BUYOUT,         // Bot buyout: item, count, buyout, current, outbid
+
+    AHB_RECORD_MAX
+};
+
+// =============================================================================
+// Fixed size record of the auction event stream, written as is to the file.
+// The file is only meant to be read back by the same build of the module.
+// =============================================================================
+
+struct AHBRecord
+{
+    uint32 time;               // Game time, in seconds
+    uint8  event;
+    uint8  reserved[3];        // Always zero
+    uint32 house;
+    uint32 count;
+    uint64 price;
+    uint32 item;
+    int32  random;
+    uint32 current;
+    uint32 outBid;
+};
+
+static_assert(sizeof(AHBRecord) == 40, "AHBRecord must stay packed in 40 bytes");
+
+// =============================================================================
+// Appends the auction event stream to a binary file.
+// The world thread fills a buffer of AHB_RECORD_BUFFER records and hands it
+// over, full or on Flush, to a dedicated thread that writes it; at most
+// AHB_RECORD_PENDING buffers wait for the disk, the records beyond are dropped
+// and counted.
+// =============================================================================
+
+class AHBRecorder
+{
+private:
+    FILE*                                _file;
+    std::vector<AHBRecord>               _buffer;   // Filled by the world thread
+
+    std::thread                          _thread;
+    mutable std::mutex                   _lock;
+    std::condition_variable              _wakeup;
+    bool                                 _stop;
+    std::vector<std::vector<AHBRecord>>  _pending;  // Handed over, not yet written
+    std::atomic<bool>                    _failed;
+    uint64                               _dropped;
+
+    void run();
+
+public:
+    AHBRecorder();
+    ~AHBRecorder();
+
+    void Start  (std::string const& path);
+    void Stop   ();
+    bool Running() const { return _thread.joinable() && !_failed; };
+
+    uint64 GetMemory() const;
+
+    void Record(AHBRecordEvent event, uint32 house, uint32 item, int32 random, uint32 count, uint64 price, uint32 current = 0, uint32 outBid = 0);
+    void Flush ();
+
+    static bool        Load        (std::string const& path, std::vector<AHBRecord>& records);
+    static char const* GetEventName(uint8 event);
+};
+
+extern AHBRecorder gRecorder;
+
+#endif // AUCTION_HOUSE_BOT_RECORDER_H
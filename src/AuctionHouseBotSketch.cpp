@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include "AuctionHouseBotSketch.h"
+
+AHBQuantileSketch::AHBQuantileSketch()
+{
+    Clear();
+}
+
+void AHBQuantileSketch::Clear()
+{
+    _size  = 0;
+    _total = 0;
+}
+
+void AHBQuantileSketch::Add(uint32 value, uint32 weight)
+{
+    if (weight == 0)
+    {
+        return;
+    }
+
+    insert(value, weight);
+}
+
+void AHBQuantileSketch::Merge(AHBQuantileSketch const& other)
+{
+    for (uint32 i = 0; i < other._size; ++i)
+    {
+        insert(other._centroids[i].value, other._centroids[i].weight);
+    }
+}
+
+void AHBQuantileSketch::Decay()
+{
+    //
+    // Halve the weights, so the new samples count more than the old ones while the shape is kept
+    //
+
+    _total = 0;
+
+    for (uint32 i = 0; i < _size; ++i)
+    {
+        _centroids[i].weight = (_centroids[i].weight + 1) / 2;
+        _total              += _centroids[i].weight;
+    }
+}
+
+void AHBQuantileSketch::insert(uint32 value, uint32 weight)
+{
+    //
+    // Keep the centroids sorted by value; identical values share the centroid
+    //
+
+    uint32 pos = 0;
+
+    while (pos < _size && _centroids[pos].value < value)
+    {
+        pos++;
+    }
+
+    _total += weight;
+
+    if (pos < _size && _centroids[pos].value == value)
+    {
+        _centroids[pos].weight += weight;
+        return;
+    }
+
+    for (uint32 i = _size; i > pos; --i)
+    {
+        _centroids[i] = _centroids[i - 1];
+    }
+
+    _centroids[pos].value  = value;
+    _centroids[pos].weight = weight;
+    _size++;
+
+    compress();
+}
+
+void AHBQuantileSketch::compress()
+{
+    while (_size > AHB_SKETCH_CENTROIDS)
+    {
+        //
+        // Find the adjacent pair which is the cheapest to merge: small weights located
+        // in the middle of the distribution. The tails are kept as precise as possible.
+        //
+
+        uint32 best     = 0;
+        double bestCost = 0;
+        uint64 before   = 0;
+
+        for (uint32 i = 0; i + 1 < _size; ++i)
+        {
+            uint64 weight = uint64(_centroids[i].weight) + _centroids[i + 1].weight;
+            double q      = (before + weight / 2.0) / _total;
+            double cost   = weight / (q * (1.0 - q) + 0.001);
+
+            if (i == 0 || cost < bestCost)
+            {
+                best     = i;
+                bestCost = cost;
+            }
+
+            before += _centroids[i].weight;
+        }
+
+        Centroid& a = _centroids[best];
+        Centroid& b = _centroids[best + 1];
+
+        uint64 weight = uint64(a.weight) + b.weight;
+
+        a.value  = uint32((uint64(a.value) * a.weight + uint64(b.value) * b.weight) / weight);
+        a.weight = uint32(weight);
+
+        for (uint32 i = best + 1; i + 1 < _size; ++i)
+        {
+            _centroids[i] = _centroids[i + 1];
+        }
+
+        _size--;
+    }
+}
+
+uint32 AHBQuantileSketch::Quantile(uint32 percent) const
+{
+    if (_size == 0)
+    {
+        return 0;
+    }
+
+    if (percent > 100)
+    {
+        percent = 100;
+    }
+
+    //
+    // Every centroid is considered to be placed in the middle of the weight it covers;
+    // the values between two centroids are linearly interpolated.
+    //
+
+    double target = _total * (percent / 100.0);
+    double center = _centroids[0].weight / 2.0;
+
+    if (target <= center)
+    {
+        return _centroids[0].value;
+    }
+
+    for (uint32 i = 0; i + 1 < _size; ++i)
+    {
+        double next = center + (_centroids[i].weight + _centroids[i + 1].weight) / 2.0;
+
+        if (target < next)
+        {
+            double ratio = (target - center) / (next - center);
+
+            return uint32(_centroids[i].value + ratio * (double(_centroids[i + 1].value) - _centroids[i].value));
+        }
+
+        center = next;
+    }
+
+    return _centroids[_size - 1].value;
+}
+
+std::vector<uint8> AHBQuantileSketch::Serialize() const
+{
+    std::vector<uint8> data;
+
+    data.reserve(_size * 8);
+
+    for (uint32 i = 0; i < _size; ++i)
+    {
+        for (uint32 shift = 0; shift < 32; shift += 8)
+        {
+            data.push_back(uint8(_centroids[i].value >> shift));
+        }
+
+        for (uint32 shift = 0; shift < 32; shift += 8)
+        {
+            data.push_back(uint8(_centroids[i].weight >> shift));
+        }
+    }
+
+    return data;
+}
+
+void AHBQuantileSketch::Deserialize(std::vector<uint8> const& data)
+{
+    Clear();
+
+    uint32 count = data.size() / 8;
+
+    if (count > AHB_SKETCH_CENTROIDS)
+    {
+        count = AHB_SKETCH_CENTROIDS;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint32 value  = 0;
+        uint32 weight = 0;
+
+        for (uint32 b = 0; b < 4; ++b)
+        {
+            value  |= uint32(data[i * 8 + b])     << (b * 8);
+            weight |= uint32(data[i * 8 + 4 + b]) << (b * 8);
+        }
+
+        Add(value, weight);
+    }
+}
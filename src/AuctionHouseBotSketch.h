@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_SKETCH_H
+#define AUCTION_HOUSE_BOT_SKETCH_H
+
+#include <vector>
+
+#include "Common.h"
+
+#define AHB_SKETCH_CENTROIDS 32
+
+// =============================================================================
+// Bounded memory quantile sketch of the per unit prices of an item.
+//
+// It is a small merging digest: at most AHB_SKETCH_CENTROIDS weighted
+// centroids sorted by value (about 256 bytes). When full, the two adjacent
+// centroids whose merge costs the least precision are collapsed; the cost
+// grows toward the tails, so the extremes stay sharp and a single outlier
+// cannot drag the central quantiles. Two sketches can be merged, which
+// allows to combine the statistics of different auction houses.
+// =============================================================================
+
+class AHBQuantileSketch
+{
+private:
+    struct Centroid
+    {
+        uint32 value;
+        uint32 weight;
+    };
+
+    Centroid _centroids[AHB_SKETCH_CENTROIDS + 1];
+    uint32   _size;
+    uint64   _total;
+
+    void insert  (uint32 value, uint32 weight);
+    void compress();
+
+public:
+    AHBQuantileSketch();
+
+    void   Add     (uint32 value, uint32 weight = 1);
+    void   Merge   (AHBQuantileSketch const& other);
+    void   Decay   ();
+    void   Clear   ();
+
+    bool   Empty   () const { return _size == 0; };
+    uint64 Total   () const { return _total; };
+
+    uint32 Quantile(uint32 percent) const;
+
+    //
+    // Persistence
+    //
+
+    std::vector<uint8> Serialize  () const;
+    void               Deserialize(std::vector<uint8> const& data);
+};
+
+#endif // AUCTION_HOUSE_BOT_SKETCH_H
@@ -0,0 +1,527 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <algorithm>
+
+#include "StringFormat.h"
+
+#include "AuctionHouseBotStats.h"
+
+//
+// Upper bounds of the histogram buckets, in microseconds
+//
+
+static const uint32 bucketBounds[AHB_STATS_BUCKETS] =
+{
+    50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000
+};
+
+//
+// Upper bounds of the hooks histogram buckets, in nanoseconds
+//
+
+static const uint32 hookBucketBounds[AHB_HOOK_BUCKETS] =
+{
+    250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000
+};
+
+AHBStats::AHBStats()
+{
+    Reset();
+}
+
+void AHBStats::Reset()
+{
+    for (uint32 i = 0; i < AHB_PHASE_MAX; ++i)
+    {
+        _phases[i].next  = 0;
+        _phases[i].total = 0;
+        _phases[i].sum   = 0;
+
+        for (uint32 j = 0; j <= AHB_STATS_BUCKETS; ++j)
+        {
+            _phases[i].buckets[j] = 0;
+        }
+    }
+
+    for (uint32 i = 0; i < AHB_COUNTER_MAX; ++i)
+    {
+        _counters[i] = 0;
+    }
+}
+
+void AHBStats::Record(AHBPhase phase, uint32 us)
+{
+    Window& window = _phases[phase];
+
+    window.samples[window.next] = us;
+    window.next                 = (window.next + 1) % AHB_STATS_WINDOW;
+    window.total++;
+
+    uint32 bucket = 0;
+
+    while (bucket < AHB_STATS_BUCKETS && us > bucketBounds[bucket])
+    {
+        bucket++;
+    }
+
+    window.buckets[bucket]++;
+    window.sum += us;
+}
+
+void AHBStats::AddCounter(AHBCounter counter, uint32 value)
+{
+    _counters[counter] += value;
+}
+
+uint64 AHBStats::GetCount(AHBPhase phase) const
+{
+    return _phases[phase].total;
+}
+
+uint64 AHBStats::GetCounter(AHBCounter counter) const
+{
+    return _counters[counter];
+}
+
+uint64 AHBStats::GetBucket(AHBPhase phase, uint32 bucket) const
+{
+    return _phases[phase].buckets[bucket];
+}
+
+uint64 AHBStats::GetSum(AHBPhase phase) const
+{
+    return _phases[phase].sum;
+}
+
+uint32 AHBStats::GetBucketBound(uint32 bucket)
+{
+    return bucketBounds[bucket];
+}
+
+void AHBStats::GetTimings(AHBPhase phase, uint32& p50, uint32& p99, uint32& max) const
+{
+    Window const& window = _phases[phase];
+    uint32        size   = window.total < AHB_STATS_WINDOW ? uint32(window.total) : AHB_STATS_WINDOW;
+
+    p50 = 0;
+    p99 = 0;
+    max = 0;
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    //
+    // Work on a copy, the window keeps the insertion order
+    //
+
+    std::vector<uint32> sorted(window.samples, window.samples + size);
+    std::sort(sorted.begin(), sorted.end());
+
+    p50 = sorted[(size - 1) * 50 / 100];
+    p99 = sorted[(size - 1) * 99 / 100];
+    max = sorted[size - 1];
+}
+
+void AHBStats::Report(std::vector<std::string>& lines) const
+{
+    for (uint32 i = 0; i < AHB_PHASE_MAX; ++i)
+    {
+        AHBPhase phase = AHBPhase(i);
+
+        if (GetCount(phase) == 0)
+        {
+            continue;
+        }
+
+        uint32 p50;
+        uint32 p99;
+        uint32 max;
+
+        GetTimings(phase, p50, p99, max);
+
+        lines.push_back(Acore::StringFormat("  {:<14} n={:<8} p50={}us p99={}us max={}us", GetPhaseName(phase), GetCount(phase), p50, p99, max));
+    }
+
+    lines.push_back(Acore::StringFormat("  noSold={} binEmpty={} loopBrk={} err={}",
+        GetCounter(AHB_COUNTER_NO_SOLD), GetCounter(AHB_COUNTER_BIN_EMPTY), GetCounter(AHB_COUNTER_LOOP_BRK), GetCounter(AHB_COUNTER_ERR)));
+
+    lines.push_back(Acore::StringFormat("  bids={} buyouts={}",
+        GetCounter(AHB_COUNTER_BIDS), GetCounter(AHB_COUNTER_BUYOUTS)));
+}
+
+char const* AHBStats::GetPhaseName(AHBPhase phase)
+{
+    switch (phase)
+    {
+    case AHB_PHASE_SELL_SELECT:
+        return "sell.select";
+    case AHB_PHASE_ITEM_CREATE:
+        return "sell.create";
+    case AHB_PHASE_PRICING:
+        return "sell.pricing";
+    case AHB_PHASE_DB_ENQUEUE:
+        return "sell.enqueue";
+    case AHB_PHASE_BUY_FETCH:
+        return "buy.fetch";
+    case AHB_PHASE_BUY_EVALUATE:
+        return "buy.evaluate";
+    case AHB_PHASE_PERSISTENCE:
+        return "buy.persist";
+    case AHB_PHASE_CYCLE:
+        return "cycle";
+    default:
+        return "unknown";
+    }
+}
+
+char const* AHBStats::GetCounterName(AHBCounter counter)
+{
+    switch (counter)
+    {
+    case AHB_COUNTER_NO_SOLD:
+        return "listings";
+    case AHB_COUNTER_BIN_EMPTY:
+        return "bin_empty";
+    case AHB_COUNTER_LOOP_BRK:
+        return "loop_break";
+    case AHB_COUNTER_ERR:
+        return "errors";
+    case AHB_COUNTER_BIDS:
+        return "bids";
+    case AHB_COUNTER_BUYOUTS:
+        return "buyouts";
+    default:
+        return "unknown";
+    }
+}
+
+char const* AHBStats::GetCounterHelp(AHBCounter counter)
+{
+    switch (counter)
+    {
+    case AHB_COUNTER_NO_SOLD:
+        return "Auctions listed by the seller";
+    case AHB_COUNTER_BIN_EMPTY:
+        return "Selections that found no eligible item in the bins";
+    case AHB_COUNTER_LOOP_BRK:
+        return "Listings skipped because no item could be selected";
+    case AHB_COUNTER_ERR:
+        return "Selected items that could not be listed";
+    case AHB_COUNTER_BIDS:
+        return "Bids placed by the buyer";
+    case AHB_COUNTER_BUYOUTS:
+        return "Auctions bought out by the buyer";
+    default:
+        return "Unknown counter";
+    }
+}
+
+AHBDbStats::AHBDbStats()
+{
+    Reset();
+}
+
+void AHBDbStats::Reset()
+{
+    for (uint32 i = 0; i < AHB_DB_SITE_MAX; ++i)
+    {
+        for (uint32 j = 0; j < AHB_DB_KIND_MAX; ++j)
+        {
+            _totals[i][j] = 0;
+            _cycle[i][j]  = 0;
+            _last[i][j]   = 0;
+            _worst[i][j]  = 0;
+        }
+    }
+
+    _cycles  = 0;
+    _inCycle = false;
+}
+
+void AHBDbStats::Count(AHBDbSite site, AHBDbKind kind, uint32 calls)
+{
+    _totals[site][kind] += calls;
+
+    if (_inCycle)
+    {
+        _cycle[site][kind] += calls;
+    }
+}
+
+void AHBDbStats::BeginCycle()
+{
+    for (uint32 i = 0; i < AHB_DB_SITE_MAX; ++i)
+    {
+        for (uint32 j = 0; j < AHB_DB_KIND_MAX; ++j)
+        {
+            _cycle[i][j] = 0;
+        }
+    }
+
+    _inCycle = true;
+}
+
+void AHBDbStats::EndCycle()
+{
+    if (!_inCycle)
+    {
+        return;
+    }
+
+    for (uint32 i = 0; i < AHB_DB_SITE_MAX; ++i)
+    {
+        for (uint32 j = 0; j < AHB_DB_KIND_MAX; ++j)
+        {
+            _last[i][j]  = _cycle[i][j];
+            _worst[i][j] = std::max(_worst[i][j], _cycle[i][j]);
+        }
+    }
+
+    _cycles++;
+    _inCycle = false;
+}
+
+void AHBDbStats::Report(std::vector<std::string>& lines) const
+{
+    uint64 roundTrips = 0;
+    uint64 sync       = 0;
+
+    for (uint32 i = 0; i < AHB_DB_SITE_MAX; ++i)
+    {
+        AHBDbSite site = AHBDbSite(i);
+
+        uint64 const* totals = _totals[site];
+        uint64 const* last   = _last[site];
+        uint64 const* worst  = _worst[site];
+
+        if (totals[AHB_DB_SYNC] + totals[AHB_DB_ASYNC] + totals[AHB_DB_APPEND] + totals[AHB_DB_COMMIT] == 0)
+        {
+            continue;
+        }
+
+        //
+        // A round trip is anything sent on its own: a query, a statement or a whole transaction
+        //
+
+        roundTrips += totals[AHB_DB_SYNC] + totals[AHB_DB_ASYNC] + totals[AHB_DB_COMMIT];
+        sync       += totals[AHB_DB_SYNC];
+
+        lines.push_back(Acore::StringFormat("  {:<14} sync={:<6} async={:<6} append={:<6} commit={:<6} lastCycle={}/{}/{}/{} worstCycle={}/{}/{}/{}",
+            GetSiteName(site), totals[AHB_DB_SYNC], totals[AHB_DB_ASYNC], totals[AHB_DB_APPEND], totals[AHB_DB_COMMIT],
+            last[AHB_DB_SYNC], last[AHB_DB_ASYNC], last[AHB_DB_APPEND], last[AHB_DB_COMMIT],
+            worst[AHB_DB_SYNC], worst[AHB_DB_ASYNC], worst[AHB_DB_APPEND], worst[AHB_DB_COMMIT]));
+    }
+
+    lines.push_back(Acore::StringFormat("  roundTrips={} sync={} cycles={}", roundTrips, sync, _cycles));
+}
+
+char const* AHBDbStats::GetSiteName(AHBDbSite site)
+{
+    switch (site)
+    {
+    case AHB_DB_BOTS_LOAD:
+        return "bots.load";
+    case AHB_DB_CONFIG_LOAD:
+        return "config.load";
+    case AHB_DB_MARKET_LOAD:
+        return "market.load";
+    case AHB_DB_MARKET_SAVE:
+        return "market.save";
+    case AHB_DB_COMMAND:
+        return "command";
+    case AHB_DB_EXPIRE:
+        return "expire";
+    case AHB_DB_SELL_LISTING:
+        return "sell.listing";
+    case AHB_DB_BUY_OUTBID:
+        return "buy.outbid";
+    case AHB_DB_BUY_BID:
+        return "buy.bid";
+    case AHB_DB_BUY_BUYOUT:
+        return "buy.buyout";
+    case AHB_DB_LOAD_TEST:
+        return "loadtest";
+    case AHB_DB_CHECKPOINT:
+        return "checkpoint";
+    case AHB_DB_SWEEP:
+        return "sweep";
+    default:
+        return "unknown";
+    }
+}
+
+char const* AHBDbStats::GetKindName(AHBDbKind kind)
+{
+    switch (kind)
+    {
+    case AHB_DB_SYNC:
+        return "sync";
+    case AHB_DB_ASYNC:
+        return "async";
+    case AHB_DB_APPEND:
+        return "append";
+    case AHB_DB_COMMIT:
+        return "commit";
+    default:
+        return "unknown";
+    }
+}
+
+AHBHookStats::AHBHookStats()
+{
+    _timings = false;
+
+    Reset();
+}
+
+void AHBHookStats::Reset()
+{
+    for (uint32 i = 0; i < AHB_HOOK_MAX; ++i)
+    {
+        _hooks[i].calls = 0;
+        _hooks[i].sum   = 0;
+        _hooks[i].max   = 0;
+
+        for (uint32 j = 0; j <= AHB_HOOK_BUCKETS; ++j)
+        {
+            _hooks[i].buckets[j] = 0;
+        }
+    }
+}
+
+void AHBHookStats::Record(AHBHook hook, uint64 ns)
+{
+    Hook& stats = _hooks[hook];
+
+    uint32 bucket = 0;
+
+    while (bucket < AHB_HOOK_BUCKETS && ns > hookBucketBounds[bucket])
+    {
+        bucket++;
+    }
+
+    stats.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    stats.sum.fetch_add(ns, std::memory_order_relaxed);
+
+    //
+    // Racing writers may lose a maximum, only when both are new maxima
+    //
+
+    if (ns > stats.max.load(std::memory_order_relaxed))
+    {
+        stats.max.store(ns, std::memory_order_relaxed);
+    }
+}
+
+uint64 AHBHookStats::GetTimed(AHBHook hook) const
+{
+    uint64 timed = 0;
+
+    for (uint32 bucket = 0; bucket <= AHB_HOOK_BUCKETS; ++bucket)
+    {
+        timed += GetBucket(hook, bucket);
+    }
+
+    return timed;
+}
+
+uint64 AHBHookStats::GetBucket(AHBHook hook, uint32 bucket) const
+{
+    return _hooks[hook].buckets[bucket].load(std::memory_order_relaxed);
+}
+
+uint64 AHBHookStats::GetSum(AHBHook hook) const
+{
+    return _hooks[hook].sum.load(std::memory_order_relaxed);
+}
+
+uint64 AHBHookStats::GetMax(AHBHook hook) const
+{
+    return _hooks[hook].max.load(std::memory_order_relaxed);
+}
+
+uint32 AHBHookStats::GetBucketBound(uint32 bucket)
+{
+    return hookBucketBounds[bucket];
+}
+
+void AHBHookStats::Report(std::vector<std::string>& lines) const
+{
+    for (uint32 i = 0; i < AHB_HOOK_MAX; ++i)
+    {
+        AHBHook hook  = AHBHook(i);
+        uint64  calls = GetCalls(hook);
+
+        if (calls == 0)
+        {
+            continue;
+        }
+
+        uint64 timed = GetTimed(hook);
+
+        if (timed == 0)
+        {
+            lines.push_back(Acore::StringFormat("  {:<18} calls={}", GetHookName(hook), calls));
+            continue;
+        }
+
+        //
+        // Percentiles from the histogram, as the upper bound of the bucket holding them
+        //
+
+        std::string percentiles;
+        uint64      cumulative = 0;
+        uint32      bucket     = 0;
+
+        for (uint32 percentile : { 50, 99 })
+        {
+            uint64 rank = (timed * percentile + 99) / 100;
+
+            while (bucket < AHB_HOOK_BUCKETS && cumulative + GetBucket(hook, bucket) < rank)
+            {
+                cumulative += GetBucket(hook, bucket);
+                bucket++;
+            }
+
+            if (bucket < AHB_HOOK_BUCKETS)
+            {
+                percentiles += Acore::StringFormat(" p{}<={}ns", percentile, hookBucketBounds[bucket]);
+            }
+            else
+            {
+                percentiles += Acore::StringFormat(" p{}>{}ns", percentile, hookBucketBounds[AHB_HOOK_BUCKETS - 1]);
+            }
+        }
+
+        lines.push_back(Acore::StringFormat("  {:<18} calls={:<8} mean={}ns{} max={}ns", GetHookName(hook), calls, GetSum(hook) / timed, percentiles, GetMax(hook)));
+    }
+}
+
+char const* AHBHookStats::GetHookName(AHBHook hook)
+{
+    switch (hook)
+    {
+    case AHB_HOOK_AUCTION_ADD:
+        return "auction.add";
+    case AHB_HOOK_AUCTION_REMOVE:
+        return "auction.remove";
+    case AHB_HOOK_AUCTION_SUCCESSFUL:
+        return "auction.successful";
+    case AHB_HOOK_AUCTION_EXPIRE:
+        return "auction.expire";
+    case AHB_HOOK_SUCCESSFUL_MAIL:
+        return "mail.successful";
+    case AHB_HOOK_EXPIRED_MAIL:
+        return "mail.expired";
+    case AHB_HOOK_OUTBID_MAIL:
+        return "mail.outbid";
+    case AHB_HOOK_MAIL_SEND:
+        return "mail.send";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_STATS_H
+#define AUCTION_HOUSE_BOT_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+
+#define AHB_STATS_WINDOW  512
+#define AHB_STATS_BUCKETS 13
+#define AHB_HOOK_BUCKETS  11
+
+//
+// Phases of an update cycle
+//
+
+enum AHBPhase
+{
+    AHB_PHASE_SELL_SELECT,     // Selection of the item from the bins
+    AHB_PHASE_ITEM_CREATE,     // Creation of the item
+    AHB_PHASE_PRICING,         // Price, stack, duration and deposit
+    AHB_PHASE_DB_ENQUEUE,      // Auction creation and database enqueue
+    AHB_PHASE_BUY_FETCH,       // Retrieval of the auctions to bid on
+    AHB_PHASE_BUY_EVALUATE,    // Evaluation of an auction
+    AHB_PHASE_PERSISTENCE,     // Bid or buyout persistence
+    AHB_PHASE_CYCLE,           // Whole update cycle
+
+    AHB_PHASE_MAX
+};
+
+//
+// Tracing counters
+//
+
+enum AHBCounter
+{
+    AHB_COUNTER_NO_SOLD,
+    AHB_COUNTER_BIN_EMPTY,
+    AHB_COUNTER_LOOP_BRK,
+    AHB_COUNTER_ERR,
+    AHB_COUNTER_BIDS,
+    AHB_COUNTER_BUYOUTS,
+
+    AHB_COUNTER_MAX
+};
+
+//
+// Places where the module talks to the database
+//
+
+enum AHBDbSite
+{
+    AHB_DB_BOTS_LOAD,          // Characters of the bots account
+    AHB_DB_CONFIG_LOAD,        // Configuration, disabled items, vendor and loot lists
+    AHB_DB_MARKET_LOAD,        // Market statistics
+    AHB_DB_MARKET_SAVE,        // Market statistics flush
+    AHB_DB_COMMAND,            // Configuration changed by a GM command
+    AHB_DB_EXPIRE,             // Early expiration of the bots auctions
+    AHB_DB_SELL_LISTING,       // New auction of the seller
+    AHB_DB_BUY_OUTBID,         // Mail to the outbidded bidder
+    AHB_DB_BUY_BID,            // Bid of the buyer
+    AHB_DB_BUY_BUYOUT,         // Buyout of the buyer
+    AHB_DB_LOAD_TEST,          // Synthetic auctions, bids and buyouts of a load test
+    AHB_DB_CHECKPOINT,         // State of the houses and of the bots, for a fast resume
+    AHB_DB_SWEEP,              // Orphaned item rows of the bots
+
+    AHB_DB_SITE_MAX
+};
+
+//
+// Kinds of database calls
+//
+
+enum AHBDbKind
+{
+    AHB_DB_SYNC,               // Blocking query or direct execute, the world thread waits
+    AHB_DB_ASYNC,              // Statement or query enqueued on its own
+    AHB_DB_APPEND,             // Statement appended to a transaction
+    AHB_DB_COMMIT,             // Transaction enqueued
+
+    AHB_DB_KIND_MAX
+};
+
+//
+// Hooks called by the core on every auction and mail of the server
+//
+
+enum AHBHook
+{
+    AHB_HOOK_AUCTION_ADD,
+    AHB_HOOK_AUCTION_REMOVE,
+    AHB_HOOK_AUCTION_SUCCESSFUL,
+    AHB_HOOK_AUCTION_EXPIRE,
+    AHB_HOOK_SUCCESSFUL_MAIL,
+    AHB_HOOK_EXPIRED_MAIL,
+    AHB_HOOK_OUTBID_MAIL,
+    AHB_HOOK_MAIL_SEND,
+
+    AHB_HOOK_MAX
+};
+
+// =============================================================================
+// Measures the time elapsed since the creation or the previous lap
+// =============================================================================
+
+class AHBPhaseClock
+{
+private:
+    std::chrono::steady_clock::time_point _start;
+
+public:
+    AHBPhaseClock() : _start(std::chrono::steady_clock::now()) { };
+
+    uint32 Lap()
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        uint32                                us  = uint32(std::chrono::duration_cast<std::chrono::microseconds>(now - _start).count());
+
+        _start = now;
+
+        return us;
+    };
+};
+
+// =============================================================================
+// Rolling timings and counters of a bot or of an auction house.
+// Only the last AHB_STATS_WINDOW samples of every phase are kept; recording
+// a sample is a plain store, the percentiles are computed on demand.
+// A cumulative histogram is kept as well for the metrics exporter.
+// =============================================================================
+
+class AHBStats
+{
+private:
+    struct Window
+    {
+        uint32 samples[AHB_STATS_WINDOW];
+        uint32 next;
+        uint64 total;
+
+        uint64 buckets[AHB_STATS_BUCKETS + 1]; // Histogram since the start, the last one is +Inf
+        uint64 sum;
+    };
+
+    Window _phases[AHB_PHASE_MAX];
+    uint64 _counters[AHB_COUNTER_MAX];
+
+public:
+    AHBStats();
+
+    void   Record    (AHBPhase phase, uint32 us);
+    void   AddCounter(AHBCounter counter, uint32 value);
+    void   Reset     ();
+
+    uint64 GetCount  (AHBPhase phase) const;
+    uint64 GetCounter(AHBCounter counter) const;
+    void   GetTimings(AHBPhase phase, uint32& p50, uint32& p99, uint32& max) const;
+    uint64 GetBucket (AHBPhase phase, uint32 bucket) const;
+    uint64 GetSum    (AHBPhase phase) const;
+
+    void   Report    (std::vector<std::string>& lines) const;
+
+    static char const* GetPhaseName  (AHBPhase phase);
+    static char const* GetCounterName(AHBCounter counter);
+    static char const* GetCounterHelp(AHBCounter counter);
+    static uint32      GetBucketBound(uint32 bucket);
+};
+
+// =============================================================================
+// Database calls of the whole module, by call site and kind.
+// The calls made between BeginCycle and EndCycle, i.e. by the bots updates,
+// are also kept for the last cycle and for the worst cycle seen; the calls
+// made outside of a cycle, like the configuration load, only count in the
+// totals. Only used from the world thread.
+// =============================================================================
+
+class AHBDbStats
+{
+private:
+    uint64 _totals[AHB_DB_SITE_MAX][AHB_DB_KIND_MAX];
+    uint64 _cycle [AHB_DB_SITE_MAX][AHB_DB_KIND_MAX];
+    uint64 _last  [AHB_DB_SITE_MAX][AHB_DB_KIND_MAX];
+    uint64 _worst [AHB_DB_SITE_MAX][AHB_DB_KIND_MAX];
+    uint64 _cycles;
+    bool   _inCycle;
+
+public:
+    AHBDbStats();
+
+    void   Count     (AHBDbSite site, AHBDbKind kind, uint32 calls = 1);
+    void   BeginCycle();
+    void   EndCycle  ();
+    void   Reset     ();
+
+    uint64 GetTotal  (AHBDbSite site, AHBDbKind kind) const { return _totals[site][kind]; };
+    uint64 GetLast   (AHBDbSite site, AHBDbKind kind) const { return _last[site][kind];   };
+    uint64 GetWorst  (AHBDbSite site, AHBDbKind kind) const { return _worst[site][kind];  };
+    uint64 GetCycles () const { return _cycles; };
+
+    void   Report    (std::vector<std::string>& lines) const;
+
+    static char const* GetSiteName(AHBDbSite site);
+    static char const* GetKindName(AHBDbKind kind);
+};
+
+extern AHBDbStats gDbStats;
+
+// =============================================================================
+// Calls and latencies of the hooks run inline with the players operations.
+// The calls are always counted; the timings cost two clock reads per call and
+// are only taken when enabled. The mail hook may run from the map threads,
+// hence the relaxed atomics.
+// =============================================================================
+
+class AHBHookStats
+{
+private:
+    struct Hook
+    {
+        std::atomic<uint64> calls;
+        std::atomic<uint64> buckets[AHB_HOOK_BUCKETS + 1]; // The last one is +Inf
+        std::atomic<uint64> sum;
+        std::atomic<uint64> max;
+    };
+
+    Hook              _hooks[AHB_HOOK_MAX];
+    std::atomic<bool> _timings;
+
+public:
+    AHBHookStats();
+
+    void   SetTimings(bool timings) { _timings.store(timings, std::memory_order_relaxed); };
+    bool   HasTimings() const       { return _timings.load(std::memory_order_relaxed);  };
+
+    void   Call  (AHBHook hook)            { _hooks[hook].calls.fetch_add(1, std::memory_order_relaxed); };
+    void   Record(AHBHook hook, uint64 ns);
+    void   Reset ();
+
+    uint64 GetCalls (AHBHook hook) const { return _hooks[hook].calls.load(std::memory_order_relaxed); };
+    uint64 GetTimed (AHBHook hook) const;
+    uint64 GetBucket(AHBHook hook, uint32 bucket) const;
+    uint64 GetSum   (AHBHook hook) const;
+    uint64 GetMax   (AHBHook hook) const;
+
+    void   Report   (std::vector<std::string>& lines) const;
+
+    static char const* GetHookName   (AHBHook hook);
+    static uint32      GetBucketBound(uint32 bucket);
+};
+
+extern AHBHookStats gHookStats;
+
+//
+// Counts a hook call, and times it until the end of the scope when enabled
+//
+
+class AHBHookTimer
+{
+private:
+    AHBHook                               _hook;
+    bool                                  _timed;
+    std::chrono::steady_clock::time_point _start;
+
+public:
+    AHBHookTimer(AHBHook hook) : _hook(hook), _timed(gHookStats.HasTimings())
+    {
+        gHookStats.Call(hook);
+
+        if (_timed)
+        {
+            _start = std::chrono::steady_clock::now();
+        }
+    };
+
+    ~AHBHookTimer()
+    {
+        if (_timed)
+        {
+            gHookStats.Record(_hook, uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count()));
+        }
+    };
+};
+
+#endif // AUCTION_HOUSE_BOT_STATS_H
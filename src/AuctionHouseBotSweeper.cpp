@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <algorithm>
+
+#include "AuctionHouseMgr.h"
+#include "DatabaseEnv.h"
+#include "Item.h"
+#include "Log.h"
+#include "StringFormat.h"
+
+#include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotSweeper.h"
+
+AHBItemSweeper::AHBItemSweeper()
+{
+    _timer         = 0;
+    _cursor        = 0;
+    _end           = 0;
+    _passes        = 0;
+    _batches       = 0;
+    _reclaimed     = 0;
+    _passReclaimed = 0;
+    _lastReclaimed = 0;
+    _skipped       = 0;
+    _pending       = false;
+}
+
+void AHBItemSweeper::Update(uint32 diff)
+{
+    _queryProcessor.ProcessReadyCallbacks();
+
+    if (!gAllianceConfig->SweepInterval || gBotsId.empty())
+    {
+        return;
+    }
+
+    _timer += diff;
+
+    if (_timer < gAllianceConfig->SweepInterval * IN_MILLISECONDS)
+    {
+        return;
+    }
+
+    //
+    // The previous range is not handled yet, try again on the next update
+    //
+
+    if (_pending)
+    {
+        return;
+    }
+
+    _timer = 0;
+
+    std::string owners;
+
+    for (uint32 id : gBotsId)
+    {
+        if (!owners.empty())
+        {
+            owners += ",";
+        }
+
+        owners += std::to_string(id);
+    }
+
+    step(std::max<uint32>(gAllianceConfig->SweepRange, 1), owners);
+}
+
+void AHBItemSweeper::step(uint32 range, std::string const& owners)
+{
+    //
+    // A new pass covers what exists right now, whatever gets created during it is for the next one
+    //
+
+    if (_end)
+    {
+        sweep(range, owners);
+        return;
+    }
+
+    _pending = true;
+
+    _queryProcessor.AddCallback(CharacterDatabase.AsyncQuery("SELECT MAX(guid) FROM item_instance").WithCallback([this, range, owners](QueryResult result)
+    {
+        if (!result || result->Fetch()[0].IsNull())
+        {
+            _pending = false;
+            return;
+        }
+
+        _end           = result->Fetch()[0].Get<uint32>();
+        _cursor        = 0;
+        _passReclaimed = 0;
+
+        sweep(range, owners);
+    }));
+
+    gDbStats.Count(AHB_DB_SWEEP, AHB_DB_ASYNC);
+}
+
+void AHBItemSweeper::sweep(uint32 range, std::string const& owners)
+{
+    uint32 first = _cursor + 1;
+    uint32 last  = _end - _cursor > range ? _cursor + range : _end;
+
+    //
+    // Rows of the bots in the range that no auction, mail or inventory references
+    //
+
+    _pending = true;
+
+    _queryProcessor.AddCallback(CharacterDatabase.AsyncQuery(Acore::StringFormat(
+        "SELECT ii.guid FROM item_instance ii "
+        "LEFT JOIN auctionhouse ah ON ah.itemguid = ii.guid "
+        "LEFT JOIN mail_items mi ON mi.item_guid = ii.guid "
+        "LEFT JOIN character_inventory ci ON ci.item = ii.guid "
+        "WHERE ii.guid BETWEEN {} AND {} AND ii.owner_guid IN ({}) AND ah.id IS NULL AND mi.item_guid IS NULL AND ci.item IS NULL",
+        first, last, owners)).WithCallback([this, last](QueryResult result)
+    {
+        reclaim(last, result);
+    }));
+
+    gDbStats.Count(AHB_DB_SWEEP, AHB_DB_ASYNC);
+}
+
+void AHBItemSweeper::reclaim(uint32 last, QueryResult result)
+{
+    _pending = false;
+    _cursor  = last;
+    _batches++;
+
+    if (result)
+    {
+        CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+        uint32                       rows  = 0;
+
+        do
+        {
+            ObjectGuid::LowType guid = result->Fetch()[0].Get<uint32>();
+
+            //
+            // An item still held by the auction manager is about to be saved with its auction
+            //
+
+            if (sAuctionMgr->GetAItem(ObjectGuid::Create<HighGuid::Item>(guid)))
+            {
+                _skipped++;
+                continue;
+            }
+
+            Item::DeleteFromDB(trans, guid);
+            rows++;
+        } while (result->NextRow());
+
+        if (rows)
+        {
+            gDbStats.Count(AHB_DB_SWEEP, AHB_DB_APPEND, uint32(trans->GetSize()));
+
+            CharacterDatabase.CommitTransaction(trans);
+            gDbStats.Count(AHB_DB_SWEEP, AHB_DB_COMMIT);
+
+            _reclaimed     += rows;
+            _passReclaimed += rows;
+        }
+    }
+
+    //
+    // End of the pass
+    //
+
+    if (_cursor >= _end)
+    {
+        _passes++;
+        _lastReclaimed = _passReclaimed;
+        _end           = 0;
+
+        LOG_INFO("module", "AHBot: item sweep {} complete, {} orphaned item rows of the bots reclaimed ({} in total)", _passes, _passReclaimed, _reclaimed);
+    }
+}
+
+void AHBItemSweeper::Report(std::vector<std::string>& lines) const
+{
+    if (!gAllianceConfig->SweepInterval)
+    {
+        lines.push_back("AHBot: the item sweeper is disabled (AuctionHouseBot.SweepInterval = 0)");
+    }
+    else if (_end)
+    {
+        lines.push_back(Acore::StringFormat("AHBot: item sweep {} at guid {} of {}, {} rows reclaimed so far", _passes + 1, _cursor, _end, _passReclaimed));
+    }
+    else
+    {
+        lines.push_back("AHBot: item sweeper waiting for its next pass");
+    }
+
+    lines.push_back(Acore::StringFormat("  passes={} batches={} reclaimed={} lastPass={} keptInMemory={}", _passes, _batches, _reclaimed, _lastReclaimed, _skipped));
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_SWEEPER_H
+#define AUCTION_HOUSE_BOT_SWEEPER_H
+
+#include <string>
+#include <vector>
+
+#include "Common.h"
+#include "DatabaseEnvFwd.h"
+#include "QueryCallbackProcessor.h"
+
+// =============================================================================
+// Removal of the item_instance rows owned by the bots that nothing references
+// anymore: no auction, no mail, no inventory slot and no item in memory.
+//
+// The table is walked by ranges of item guids, one range every
+// AuctionHouseBot.SweepInterval seconds, up to the highest guid present when
+// the pass started; items created afterwards get higher guids and are left to
+// the next pass. The queries run asynchronously, their results are handled on
+// the world thread by Update; a range is only requested once the previous one
+// has been handled. Only driven from the world thread.
+// =============================================================================
+
+class AHBItemSweeper
+{
+private:
+    uint32 _timer;
+
+    uint32 _cursor;                              // Last guid examined in the current pass
+    uint32 _end;                                 // Highest guid of the current pass, 0 between passes
+
+    uint32 _passes;
+    uint64 _batches;
+    uint64 _reclaimed;
+    uint64 _passReclaimed;
+    uint64 _lastReclaimed;                       // Rows reclaimed by the last complete pass
+    uint64 _skipped;                             // Unreferenced rows kept because the item is in memory
+
+    bool                   _pending;             // A query is in flight
+    QueryCallbackProcessor _queryProcessor;
+
+    void step   (uint32 range, std::string const& owners);
+    void sweep  (uint32 range, std::string const& owners);
+    void reclaim(uint32 last, QueryResult result);
+
+public:
+    AHBItemSweeper();
+
+    void Update(uint32 diff);
+    void Report(std::vector<std::string>& lines) const;
+};
+
+extern AHBItemSweeper gSweeper;
+
+#endif // AUCTION_HOUSE_BOT_SWEEPER_H
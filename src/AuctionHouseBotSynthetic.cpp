@@ -0,0 +1,459 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <set>
+
+#include "StringFormat.h"
+
+#include "AuctionHouseBot.h"
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotJob.h"
+#include "AuctionHouseBotRandom.h"
+#include "AuctionHouseBotStats.h"
+#include "AuctionHouseBotSynthetic.h"
+
+//
+// Classes given to the templates that are not trade goods, with their weights
+//
+
+static const uint32 itemClasses[][2] =
+{
+    { ITEM_CLASS_ARMOR     , 40 },
+    { ITEM_CLASS_WEAPON    , 15 },
+    { ITEM_CLASS_CONSUMABLE, 12 },
+    { ITEM_CLASS_MISC      , 10 },
+    { ITEM_CLASS_RECIPE    ,  8 },
+    { ITEM_CLASS_GEM       ,  5 },
+    { ITEM_CLASS_QUEST     ,  4 },
+    { ITEM_CLASS_CONTAINER ,  3 },
+    { ITEM_CLASS_GLYPH     ,  2 },
+    { ITEM_CLASS_KEY       ,  1 }
+};
+
+AHBSyntheticProfile::AHBSyntheticProfile()
+{
+    uint32 qualities[] = { 12, 35, 35, 12, 5, 1, 0 };
+    uint32 bindings[]  = { 40, 30, 25, 3, 2 };
+
+    for (uint32 i = 0; i <= AHB_MAX_QUALITY; ++i)
+    {
+        Qualities[i] = qualities[i];
+    }
+
+    for (uint32 i = 0; i <= BIND_QUEST_ITEM; ++i)
+    {
+        Bindings[i] = bindings[i];
+    }
+
+    TradeGoods = 8;
+    Unsellable = 10;
+    Vendor     = 10;
+    Loot       = 55;
+}
+
+void AHBGenerateTemplates(AHBSyntheticProfile const& profile, uint32 count, uint32 seed, ItemTemplateContainer& store, std::vector<uint32>& npcItems, std::vector<uint32>& lootItems)
+{
+    std::mt19937 random(seed);
+
+    std::discrete_distribution<uint32> quality(profile.Qualities, profile.Qualities + AHB_MAX_QUALITY + 1);
+    std::discrete_distribution<uint32> binding(profile.Bindings , profile.Bindings  + BIND_QUEST_ITEM + 1);
+
+    std::vector<uint32> classWeights;
+
+    for (auto const& itemClass : itemClasses)
+    {
+        classWeights.push_back(itemClass[1]);
+    }
+
+    std::discrete_distribution<uint32> itemClass(classWeights.begin(), classWeights.end());
+
+    std::uniform_int_distribution<uint32> percent(0, 99);
+    std::uniform_int_distribution<uint32> price  (1, 100000);
+    std::uniform_int_distribution<uint32> level  (1, 80);
+
+    store.reserve(count);
+
+    for (uint32 id = 1; id <= count; ++id)
+    {
+        ItemTemplate& prototype = store[id];
+
+        prototype.ItemId            = id;
+        prototype.Quality           = quality(random);
+        prototype.Bonding           = binding(random);
+        prototype.Class             = percent(random) < profile.TradeGoods ? uint32(ITEM_CLASS_TRADE_GOODS) : itemClasses[itemClass(random)][0];
+        prototype.ItemLevel         = level(random);
+        prototype.RequiredLevel     = level(random);
+        prototype.RequiredSkillRank = 0;
+        prototype.AllowableClass    = -1;
+        prototype.Stackable         = prototype.Class == ITEM_CLASS_TRADE_GOODS ? 20 : 1;
+
+        if (percent(random) >= profile.Unsellable)
+        {
+            prototype.SellPrice = price(random) * (prototype.Quality + 1);
+            prototype.BuyPrice  = prototype.SellPrice * 4;
+        }
+
+        if (percent(random) < profile.Vendor)
+        {
+            npcItems.push_back(id);
+        }
+
+        if (percent(random) < profile.Loot)
+        {
+            lootItems.push_back(id);
+        }
+    }
+}
+
+//
+// The bins of a configuration, in category order
+//
+
+static std::vector<std::set<uint32>*> getBins(AHBConfig& config)
+{
+    return { &config.GreyTradeGoodsBin, &config.WhiteTradeGoodsBin, &config.GreenTradeGoodsBin, &config.BlueTradeGoodsBin,
+             &config.PurpleTradeGoodsBin, &config.OrangeTradeGoodsBin, &config.YellowTradeGoodsBin,
+             &config.GreyItemsBin, &config.WhiteItemsBin, &config.GreenItemsBin, &config.BlueItemsBin,
+             &config.PurpleItemsBin, &config.OrangeItemsBin, &config.YellowItemsBin };
+}
+
+void AHBGenerateAuctions(AHBConfig* config, ItemTemplateContainer const& store, uint32 count, uint32 botId, uint32 seed, std::vector<AHBSyntheticAuction>& auctions)
+{
+    std::vector<uint32> items;
+
+    for (std::set<uint32> const* bin : getBins(*config))
+    {
+        items.insert(items.end(), bin->begin(), bin->end());
+    }
+
+    if (items.empty())
+    {
+        return;
+    }
+
+    std::mt19937 random(seed);
+
+    std::uniform_int_distribution<size_t> item   (0, items.size() - 1);
+    std::uniform_int_distribution<uint32> percent(0, 99);
+
+    auctions.reserve(count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        ItemTemplate const& prototype = store.at(items[item(random)]);
+
+        AHBSyntheticAuction auction;
+
+        auction.item     = prototype.ItemId;
+        auction.count    = std::uniform_int_distribution<uint32>(1, std::max<uint32>(prototype.Stackable, 1))(random);
+        auction.owner    = percent(random) < 50 ? botId : botId + 1;
+        auction.startbid = std::max<uint32>(prototype.SellPrice, 1) * auction.count;
+        auction.bid      = percent(random) < 30 ? auction.startbid + auction.startbid * percent(random) / 100 : 0;
+
+        //
+        // As AuctionEntry::GetAuctionOutBid
+        //
+
+        auction.outBid   = std::max<uint32>(auction.bid * 5 / 100, 1);
+
+        auctions.push_back(auction);
+    }
+}
+
+void AHBDecisionBenchmark(AHBConfig* config, AHBSyntheticProfile const& profile, uint32 botId, uint32 seed, std::vector<std::string>& lines)
+{
+    for (uint32 templates : { 10000, 100000 })
+    {
+        ItemTemplateContainer store;
+        std::vector<uint32>   npcItems;
+        std::vector<uint32>   lootItems;
+
+        AHBGenerateTemplates(profile, templates, seed, store, npcItems, lootItems);
+
+        //
+        // A copy of the configuration keeps the filters, the lists and bins come from the generated store
+        //
+
+        AHBConfig scratch(config->GetAHID(), config);
+
+        scratch.NpcItems.clear();
+        scratch.LootItems.clear();
+
+        for (std::set<uint32>* bin : getBins(scratch))
+        {
+            bin->clear();
+        }
+
+        scratch.NpcItems.insert (npcItems.begin() , npcItems.end());
+        scratch.LootItems.insert(lootItems.begin(), lootItems.end());
+
+        scratch.InitializeBins(&store);
+        scratch.CalculatePercents();
+
+        uint64 binned = 0;
+
+        for (std::set<uint32> const* bin : getBins(scratch))
+        {
+            binned += bin->size();
+        }
+
+        for (uint32 count : { 1000, 10000, 100000, 1000000 })
+        {
+            if (gJob.Cancelled())
+            {
+                return;
+            }
+
+            std::vector<AHBSyntheticAuction> auctions;
+
+            AHBGenerateAuctions(&scratch, store, count, botId, seed, auctions);
+
+            lines.push_back(Acore::StringFormat("{} templates ({} binned), {} auctions", templates, binned, auctions.size()));
+
+            //
+            // A bot of its own, seeded, so that two runs take the same decisions
+            //
+
+            AuctionHouseBot simulator(0, botId);
+
+            simulator.Seed(seed);
+            simulator.Benchmark(&scratch, store, auctions, lines);
+        }
+    }
+}
+
+//
+// Resident memory of the process and its high-water mark, in kB; zero where /proc is not available
+//
+
+static void getMemory(uint64& resident, uint64& highWater)
+{
+    std::ifstream status("/proc/self/status");
+    std::string   line;
+
+    resident  = 0;
+    highWater = 0;
+
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+        {
+            resident = strtoull(line.c_str() + 6, NULL, 10);
+        }
+        else if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            highWater = strtoull(line.c_str() + 6, NULL, 10);
+        }
+    }
+}
+
+//
+// Starts a new high-water mark at the current resident memory (Linux 4.0 and later)
+//
+
+static bool resetHighWater()
+{
+    std::ofstream clear("/proc/self/clear_refs");
+
+    clear << "5";
+    clear.flush();
+
+    return bool(clear);
+}
+
+//
+// Duration, resident memory growth and peak memory growth of a stage of the scaling benchmark
+//
+
+struct AHBScalingStage
+{
+    uint32 time;
+    uint64 memory;
+    uint64 peak;                           // Zero where the high-water mark cannot be reset
+};
+
+template<class Stage>
+static AHBScalingStage runStage(Stage stage)
+{
+    AHBScalingStage result;
+    uint64          resident;
+    uint64          highWater;
+    bool            peak = resetHighWater();
+
+    getMemory(resident, highWater);
+
+    uint64        before = resident;
+    AHBPhaseClock clock;
+
+    stage();
+
+    result.time = clock.Lap();
+
+    getMemory(resident, highWater);
+
+    result.memory = resident - std::min(resident, before);
+    result.peak   = peak ? highWater - std::min(highWater, before) : 0;
+
+    return result;
+}
+
+void AHBScalingBenchmark(AHBConfig* config, AHBSyntheticProfile const& profile, uint32 maxTemplates, uint32 seed, std::vector<std::string>& lines)
+{
+    std::set<uint32> botsIds = { AHB_SCALING_BOT };
+
+    for (uint32 templates = AHB_SCALING_MIN_TEMPLATES; templates <= maxTemplates; templates *= 10)
+    {
+        if (gJob.Cancelled())
+        {
+            return;
+        }
+
+        ItemTemplateContainer store;
+        std::vector<uint32>   npcItems;
+        std::vector<uint32>   lootItems;
+
+        //
+        // Generation, not part of the startup but its memory is what the core would hold
+        //
+
+        AHBScalingStage generate = runStage([&]()
+        {
+            AHBGenerateTemplates(profile, templates, seed, store, npcItems, lootItems);
+        });
+
+        //
+        // A copy of the configuration keeps the filters but not the lists and bins
+        //
+
+        AHBConfig scratch(config->GetAHID(), config);
+
+        scratch.NpcItems.clear();
+        scratch.LootItems.clear();
+
+        for (std::set<uint32>* bin : getBins(scratch))
+        {
+            bin->clear();
+        }
+
+        //
+        // Vendor and loot lists, as filled from the query results
+        //
+
+        AHBScalingStage sets = runStage([&]()
+        {
+            for (uint32 id : npcItems)
+            {
+                scratch.NpcItems.insert(id);
+            }
+
+            for (uint32 id : lootItems)
+            {
+                scratch.LootItems.insert(id);
+            }
+        });
+
+        //
+        // Filters and bins
+        //
+
+        AHBScalingStage bins = runStage([&]()
+        {
+            scratch.InitializeBins(&store);
+        });
+
+        uint64 binned = 0;
+
+        for (std::set<uint32> const* bin : getBins(scratch))
+        {
+            binned += bin->size();
+        }
+
+        //
+        // Scan of the listed auctions, on generated ones; the template lookup stands for the item lookup of the core
+        //
+
+        std::vector<AHBSyntheticAuction> auctions;
+
+        AHBGenerateAuctions(&scratch, store, AHB_SCALING_AUCTIONS, AHB_SCALING_BOT, seed, auctions);
+
+        AHBScalingStage scan = runStage([&]()
+        {
+            scratch.ResetItemCounts();
+
+            for (uint32 i = 0; i < auctions.size(); ++i)
+            {
+                scratch.CountAuction(auctions[i].owner, i + 1, &store.at(auctions[i].item), botsIds);
+            }
+        });
+
+        //
+        // The growth of the resident memory is a lower bound: the allocator reuses what earlier stages freed.
+        // The peak is the growth of the high-water mark of the process during the stage alone.
+        //
+
+        lines.push_back(Acore::StringFormat("{} templates: generated in {}ms (RSS +{}kB, peak +{}kB)", templates, generate.time / 1000, generate.memory, generate.peak));
+        lines.push_back(Acore::StringFormat("  sets {}ms (RSS +{}kB, peak +{}kB, {} vendor, {} loot)", sets.time / 1000, sets.memory, sets.peak, scratch.NpcItems.size(), scratch.LootItems.size()));
+        lines.push_back(Acore::StringFormat("  bins {}ms (RSS +{}kB, peak +{}kB, {} binned)", bins.time / 1000, bins.memory, bins.peak, binned));
+        lines.push_back(Acore::StringFormat("  auction scan {}ms (RSS +{}kB, peak +{}kB, {} auctions)", scan.time / 1000, scan.memory, scan.peak, auctions.size()));
+
+        if (templates > maxTemplates / 10)
+        {
+            break;
+        }
+    }
+}
+
+bool AHBMarketReplayCheck(AHBConfig* config, uint32 seed, std::vector<std::string>& lines)
+{
+    AHBConfig first (config->GetAHID(), config);
+    AHBConfig second(config->GetAHID(), config);
+
+    for (AHBConfig* copy : { &first, &second })
+    {
+        copy->DebugOutConfig       = false;
+        copy->MarketMergeHouses    = false;
+        copy->MarketResetThreshold = AHB_REPLAY_CHECK_THRESHOLD;
+
+        //
+        // The outcomes and the stream of the market are seeded alike for both copies
+        //
+
+        AHBRandom outcomes;
+        AHBRandom random;
+
+        outcomes.Seed(seed);
+        random.Seed  (seed);
+
+        for (uint32 event = 0; event < AHB_REPLAY_CHECK_EVENTS; ++event)
+        {
+            uint32 item  = outcomes.Range(1, AHB_REPLAY_CHECK_ITEMS);
+            uint32 count = outcomes.Range(1, 20);
+            uint32 price = outcomes.Range(1, 100000) * count;
+
+            copy->UpdateItemStats(item, 0, count, price, random);
+        }
+    }
+
+    uint32 differ = 0;
+
+    for (uint32 item = 1; item <= AHB_REPLAY_CHECK_ITEMS; ++item)
+    {
+        if (first.GetItemQuantile(item, 0, 50) != second.GetItemQuantile(item, 0, 50))
+        {
+            differ++;
+        }
+    }
+
+    if (differ)
+    {
+        lines.push_back(Acore::StringFormat("market replay check FAILED: the median of {} of {} items differs between two runs with the seed {}", differ, AHB_REPLAY_CHECK_ITEMS, seed));
+        return false;
+    }
+
+    lines.push_back(Acore::StringFormat("market replay check passed: {} outcomes, the medians of {} items match between two runs with the seed {}", AHB_REPLAY_CHECK_EVENTS, AHB_REPLAY_CHECK_ITEMS, seed));
+    return true;
+}
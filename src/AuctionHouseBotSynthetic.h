@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_SYNTHETIC_H
+#define AUCTION_HOUSE_BOT_SYNTHETIC_H
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+#include "ObjectMgr.h"
+
+#include "AuctionHouseBotCommon.h"
+
+class AHBConfig;
+
+#define AHB_SCALING_MIN_TEMPLATES 10000
+#define AHB_SCALING_MAX_TEMPLATES 1000000
+#define AHB_SCALING_AUCTIONS      100000
+#define AHB_SCALING_BOT           1
+
+#define AHB_REPLAY_CHECK_ITEMS     1000
+#define AHB_REPLAY_CHECK_EVENTS    100000
+#define AHB_REPLAY_CHECK_THRESHOLD 20
+
+// =============================================================================
+// Shape of a generated item template store. The weights are relative to each
+// other, the ratios are percentages of the generated templates.
+// The defaults roughly follow the stock 3.3.5 world database.
+// =============================================================================
+
+struct AHBSyntheticProfile
+{
+    uint32 Qualities[AHB_MAX_QUALITY + 1]; // Weights, by quality
+    uint32 Bindings[BIND_QUEST_ITEM + 1];  // Weights, by binding type
+    uint32 TradeGoods;                     // Ratio of trade goods
+    uint32 Unsellable;                     // Ratio of templates without any price
+    uint32 Vendor;                         // Ratio of templates sold by vendors
+    uint32 Loot;                           // Ratio of templates found in loot tables
+
+    AHBSyntheticProfile();
+};
+
+//
+// Auction standing in for an AuctionEntry of the core, with the item it holds
+//
+
+struct AHBSyntheticAuction
+{
+    uint32 item;
+    uint32 count;
+    uint32 owner;                          // Low guid of the seller
+    uint32 startbid;
+    uint32 bid;                            // Zero when there is no bid yet
+    uint32 outBid;                         // Minimal increment over the current bid
+};
+
+// =============================================================================
+// Generation of the templates, and of the vendor and loot lists that the
+// configuration would otherwise load from the world database
+// =============================================================================
+
+void AHBGenerateTemplates(AHBSyntheticProfile const& profile, uint32 count, uint32 seed, ItemTemplateContainer& store, std::vector<uint32>& npcItems, std::vector<uint32>& lootItems);
+
+// =============================================================================
+// Generation of the auctions of a house on the templates of the given bins,
+// half of them owned by the given bot
+// =============================================================================
+
+void AHBGenerateAuctions(AHBConfig* config, ItemTemplateContainer const& store, uint32 count, uint32 botId, uint32 seed, std::vector<AHBSyntheticAuction>& auctions);
+
+// =============================================================================
+// Times the selling and buying decisions of a copy of the configuration
+// against generated stores of 10k and 100k templates, each with 1k, 10k, 100k
+// and 1M generated auctions
+// =============================================================================
+
+void AHBDecisionBenchmark(AHBConfig* config, AHBSyntheticProfile const& profile, uint32 botId, uint32 seed, std::vector<std::string>& lines);
+
+// =============================================================================
+// Times the startup stages of a copy of the configuration against generated
+// stores of AHB_SCALING_MIN_TEMPLATES templates, then ten times more up to the
+// given maximum, at most AHB_SCALING_MAX_TEMPLATES. The stages are the vendor
+// and loot lists, the bins and the scan of AHB_SCALING_AUCTIONS generated
+// auctions, each with its own peak memory.
+// =============================================================================
+
+void AHBScalingBenchmark(AHBConfig* config, AHBSyntheticProfile const& profile, uint32 maxTemplates, uint32 seed, std::vector<std::string>& lines);
+
+// =============================================================================
+// Feeds the same generated auction outcomes to two copies of the configuration
+// with the same seed, resetting the market often, and checks that both learn
+// the same median price for every item
+// =============================================================================
+
+bool AHBMarketReplayCheck(AHBConfig* config, uint32 seed, std::vector<std::string>& lines);
+
+#endif // AUCTION_HOUSE_BOT_SYNTHETIC_H
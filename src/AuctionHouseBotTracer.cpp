@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include "GameTime.h"
+#include "Log.h"
+#include "StringFormat.h"
+
+#include "AuctionHouseBotTracer.h"
+
+AHBTracer::AHBTracer() : _next(0)
+{
+    for (uint32 i = 0; i < AHB_TRACE_SIZE; ++i)
+    {
+        _records[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+void AHBTracer::Trace(bool echo, AHBTraceEvent event, uint32 bot, uint32 house, uint32 item, uint32 count, uint64 value1, uint64 value2, uint64 value3)
+{
+    uint64          index  = _next.fetch_add(1, std::memory_order_relaxed);
+    AHBTraceRecord& record = _records[index & (AHB_TRACE_SIZE - 1)];
+
+    //
+    // Mark the slot as being written, fill it, then publish it
+    //
+
+    record.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    record.time      = uint32(GameTime::GetGameTimeMS().count());
+    record.event     = event;
+    record.house     = uint8(house);
+    record.count     = uint16(count);
+    record.bot       = bot;
+    record.item      = item;
+    record.values[0] = value1;
+    record.values[1] = value2;
+    record.values[2] = value3;
+
+    record.sequence.store(index + 1, std::memory_order_release);
+
+    //
+    // Legacy behaviour: the event is also sent to the logger, synchronously
+    //
+
+    if (echo)
+    {
+        uint64 values[3] = { value1, value2, value3 };
+
+        LOG_INFO("module", "{}", Format(record.time, event, bot, house, item, count, values));
+    }
+}
+
+void AHBTracer::Dump(std::vector<std::string>& lines, uint32 max) const
+{
+    uint64 next  = _next.load(std::memory_order_acquire);
+    uint64 count = next < AHB_TRACE_SIZE ? next : AHB_TRACE_SIZE;
+
+    if (max && count > max)
+    {
+        count = max;
+    }
+
+    for (uint64 index = next - count; index < next; ++index)
+    {
+        AHBTraceRecord const& record = _records[index & (AHB_TRACE_SIZE - 1)];
+
+        if (record.sequence.load(std::memory_order_acquire) != index + 1)
+        {
+            continue;
+        }
+
+        uint32 time      = record.time;
+        uint8  event     = record.event;
+        uint32 house     = record.house;
+        uint32 items     = record.count;
+        uint32 bot       = record.bot;
+        uint32 item      = record.item;
+        uint64 values[3] = { record.values[0], record.values[1], record.values[2] };
+
+        //
+        // Discard the record if it has been overwritten while being copied
+        //
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (record.sequence.load(std::memory_order_relaxed) != index + 1)
+        {
+            continue;
+        }
+
+        lines.push_back(Format(time, event, bot, house, item, items, values));
+    }
+}
+
+std::string AHBTracer::Format(uint32 time, uint8 event, uint32 bot, uint32 house, uint32 item, uint32 count, uint64 const* values)
+{
+    switch (event)
+    {
+    case AHB_TRACE_LISTING:
+        return Acore::StringFormat("[{}] AHBot [{}]: listing ah={}, item={}, stack={}, bid={}, buyout={}", time, bot, house, item, count, values[0], values[1]);
+    case AHB_TRACE_SELL_CYCLE:
+        return Acore::StringFormat("[{}] AHBot [{}]: sell cycle ah={}, req={}, sold={}, loopBrk={}, binEmpty={}, err={}", time, bot, house, item, count, values[0], values[1], values[2]);
+    case AHB_TRACE_BID_EVALUATION:
+        return Acore::StringFormat("[{}] AHBot [{}]: evaluation ah={}, item={}, stack={}, current={}, max={}, bid={}", time, bot, house, item, count, values[0], values[1], values[2]);
+    case AHB_TRACE_BID:
+        return Acore::StringFormat("[{}] AHBot [{}]: new bid ah={}, item={}, stack={}, current={}, bid={}, buyout={}", time, bot, house, item, count, values[0], values[1], values[2]);
+    case AHB_TRACE_BUYOUT:
+        return Acore::StringFormat("[{}] AHBot [{}]: bought ah={}, item={}, stack={}, current={}, buyout={}", time, bot, house, item, count, values[0], values[1]);
+    default:
+        return Acore::StringFormat("[{}] AHBot [{}]: unknown event {}", time, bot, uint32(event));
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_TRACER_H
+#define AUCTION_HOUSE_BOT_TRACER_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+
+#define AHB_TRACE_SIZE 8192 // Must be a power of two
+
+//
+// Traced events
+//
+
+enum AHBTraceEvent : uint8
+{
+    AHB_TRACE_NONE,
+    AHB_TRACE_LISTING,         // item, count, bid, buyout
+    AHB_TRACE_SELL_CYCLE,      // requested, sold, loopBrk, binEmpty + err
+    AHB_TRACE_BID_EVALUATION,  // item, count, current, max, bid
+    AHB_TRACE_BID,             // item, count, current, bid, buyout
+    AHB_TRACE_BUYOUT           // item, count, current, buyout
+};
+
+// =============================================================================
+// Fixed size ring of compact binary trace records.
+//
+// Recording claims a slot with a single atomic increment and copies a few
+// integers, nothing is formatted nor allocated: it can stay on permanently.
+// The oldest records are overwritten; the records are turned into text only
+// when dumped. A sequence number written last tells apart the slots that are
+// being overwritten while dumping.
+// =============================================================================
+
+struct AHBTraceRecord
+{
+    std::atomic<uint64> sequence;
+
+    uint32 time;               // Game time, in milliseconds
+    uint8  event;
+    uint8  house;
+    uint16 count;
+    uint32 bot;
+    uint32 item;
+    uint64 values[3];
+};
+
+class AHBTracer
+{
+private:
+    AHBTraceRecord      _records[AHB_TRACE_SIZE];
+    std::atomic<uint64> _next;
+
+public:
+    AHBTracer();
+
+    void   Trace(bool echo, AHBTraceEvent event, uint32 bot, uint32 house, uint32 item, uint32 count, uint64 value1 = 0, uint64 value2 = 0, uint64 value3 = 0);
+
+    uint64 GetTotal() const { return _next.load(std::memory_order_relaxed); };
+
+    void   Dump(std::vector<std::string>& lines, uint32 max) const;
+
+    static std::string Format(uint32 time, uint8 event, uint32 bot, uint32 house, uint32 item, uint32 count, uint64 const* values);
+};
+
+extern AHBTracer gTracer;
+
+#endif // AUCTION_HOUSE_BOT_TRACER_H
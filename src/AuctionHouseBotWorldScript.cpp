@@ -3,10 +3,18 @@
  */
 
 #include "Config.h"
+#include "DatabaseEnv.h"
 #include "Log.h"
 
 #include "AuctionHouseBot.h"
+#include "AuctionHouseBotColumnar.h"
 #include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotJob.h"
+#include "AuctionHouseBotLoad.h"
+#include "AuctionHouseBotPopulation.h"
+#include "AuctionHouseBotRandom.h"
+#include "AuctionHouseBotRecorder.h"
+#include "AuctionHouseBotSweeper.h"
 #include "AuctionHouseBotWorldScript.h"
 
 // =============================================================================
@@ -15,7 +23,10 @@
 
 AHBot_WorldScript::AHBot_WorldScript() : WorldScript("AHBot_WorldScript")
 {
-
+    _marketFlushTimer = 0;
+    _metricsTimer     = 0;
+    _recordTimer      = 0;
+    _columnarTimer    = 0;
 }
 
 void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
@@ -40,7 +51,12 @@ void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
     }
     else
     {
-        QueryResult result = CharacterDatabase.Query("SELECT guid FROM characters WHERE account = {}", account);
+        CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHARS_BY_ACCOUNT_ID);
+        stmt->SetData(0, account);
+
+        PreparedQueryResult result = CharacterDatabase.Query(stmt);
+
+        gDbStats.Count(AHB_DB_BOTS_LOAD, AHB_DB_SYNC);
 
         if (result)
         {
@@ -100,6 +116,12 @@ void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
             LOG_INFO("module", "AHBot: Reloading the bots");
         }
 
+        //
+        // Checkpoint the current state, so that the houses resume from it instead of recounting
+        //
+
+        SaveCheckpoint();
+
         //
         // Clear the bots array; this way they wont be used anymore during the initialization stage.
         //
@@ -114,11 +136,23 @@ void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
         gHordeConfig->Initialize   (gBotsId);
         gNeutralConfig->Initialize (gBotsId);
 
+        AHBUpdateMirrors();
+
         //
         // Start again the bots
         //
 
         PopulateBots();
+
+        //
+        // The metrics and record files may have been changed
+        //
+
+        _exporter.Start(gAllianceConfig->MetricsFile);
+        gRecorder.Start(gAllianceConfig->RecordFile);
+        gColumnar.Start(gAllianceConfig->ColumnarDirectory);
+
+        gHookStats.SetTimings(gAllianceConfig->HookTimings);
     }
 }
 
@@ -134,11 +168,33 @@ void AHBot_WorldScript::OnStartup()
     gHordeConfig->Initialize   (gBotsId);
     gNeutralConfig->Initialize (gBotsId);
 
+    AHBUpdateMirrors();
+
+    //
+    // Restore the market prices learned during the previous runs
+    //
+
+    LoadMarketStats();
+
     //
     // Starts the bots
     //
 
     PopulateBots();
+
+    //
+    // Starts writing the metrics and recording the events, if requested
+    //
+
+    _exporter.Start(gAllianceConfig->MetricsFile);
+    gRecorder.Start(gAllianceConfig->RecordFile);
+    gColumnar.Start(gAllianceConfig->ColumnarDirectory);
+
+    //
+    // Hooks timings, if requested
+    //
+
+    gHookStats.SetTimings(gAllianceConfig->HookTimings);
 }
 
 void AHBot_WorldScript::DeleteBots()
@@ -186,6 +242,214 @@ void AHBot_WorldScript::PopulateBots()
         AuctionHouseBot* bot = new AuctionHouseBot(account, id);
         bot->Initialize(gAllianceConfig, gHordeConfig, gNeutralConfig);
 
+        if (gAllianceConfig->RandomSeed)
+        {
+            bot->Seed(gAllianceConfig->RandomSeed);
+        }
+
         gBots.insert(bot);
     }
+
+    if (gAllianceConfig->RandomSeed)
+    {
+        gMarketRandom.Seed(gAllianceConfig->RandomSeed);
+    }
+}
+
+void AHBot_WorldScript::OnUpdate(uint32 diff)
+{
+    //
+    // Flush the market statistics in small batches, so the database is not hit by a single huge write
+    //
+
+    if (gAllianceConfig->MarketPersistence)
+    {
+        _marketFlushTimer += diff;
+
+        if (_marketFlushTimer >= gAllianceConfig->MarketFlushInterval * IN_MILLISECONDS)
+        {
+            _marketFlushTimer = 0;
+
+            SaveMarketStats(false);
+        }
+    }
+
+    //
+    // Take a snapshot of the metrics; the file is written by the exporter thread
+    //
+
+    if (_exporter.Running())
+    {
+        _metricsTimer += diff;
+
+        if (_metricsTimer >= gAllianceConfig->MetricsInterval * IN_MILLISECONDS)
+        {
+            _metricsTimer = 0;
+
+            _exporter.Collect();
+        }
+    }
+
+    //
+    // Do not keep the recorded events in memory for too long on a quiet server
+    //
+
+    if (gRecorder.Running())
+    {
+        _recordTimer += diff;
+
+        if (_recordTimer >= MINUTE * IN_MILLISECONDS)
+        {
+            _recordTimer = 0;
+
+            gRecorder.Flush();
+        }
+    }
+
+    //
+    // Columnar snapshots of the houses; the files are written by the columnar writer thread
+    //
+
+    if (gColumnar.Running())
+    {
+        _columnarTimer += diff;
+
+        if (_columnarTimer >= gAllianceConfig->ColumnarInterval * IN_MILLISECONDS)
+        {
+            _columnarTimer = 0;
+
+            for (AHBConfig* config : { gAllianceConfig, gHordeConfig, gNeutralConfig })
+            {
+                gColumnar.Snapshot(config);
+            }
+        }
+    }
+
+    //
+    // Synthetic activity of a running load test
+    //
+
+    gLoadGenerator.Update(diff);
+
+    //
+    // Orphaned item rows of the bots, a range of guids at a time
+    //
+
+    gSweeper.Update(diff);
+
+    //
+    // Sample the online population for the quotas
+    //
+
+    gPopulation.Update(diff);
+}
+
+void AHBot_WorldScript::OnShutdown()
+{
+    gLoadGenerator.Stop();
+    gJob.Stop();
+
+    //
+    // Write whatever is left, synchronously, before the database goes away
+    //
+
+    if (gAllianceConfig->MarketPersistence)
+    {
+        SaveMarketStats(true);
+    }
+
+    SaveCheckpoint();
+
+    //
+    // Last snapshot of the metrics, then wait for the writer
+    //
+
+    _exporter.Collect();
+    _exporter.Stop();
+
+    gRecorder.Stop();
+    gColumnar.Stop();
+}
+
+void AHBot_WorldScript::LoadMarketStats()
+{
+    if (!gAllianceConfig->MarketPersistence)
+    {
+        return;
+    }
+
+    //
+    // All the houses are loaded with a single query
+    //
+
+    QueryResult result = WorldDatabase.Query("SELECT auctionhouse, item, random, samples, total, sketch FROM mod_auctionhousebot_market");
+
+    gDbStats.Count(AHB_DB_MARKET_LOAD, AHB_DB_SYNC);
+
+    if (!result)
+    {
+        return;
+    }
+
+    uint32 loaded = 0;
+
+    do
+    {
+        Field* fields = result->Fetch();
+
+        uint32 ahID   = fields[0].Get<uint32>();
+        uint32 item   = fields[1].Get<uint32>();
+        int32  random = fields[2].Get<int32>();
+        uint32 count  = fields[3].Get<uint32>();
+        uint64 sum    = fields[4].Get<uint64>();
+        Binary sketch = fields[5].Get<Binary>();
+
+        switch (ahID)
+        {
+        case 2:
+            gAllianceConfig->LoadItemStats(item, random, count, sum, sketch);
+            break;
+        case 6:
+            gHordeConfig->LoadItemStats(item, random, count, sum, sketch);
+            break;
+        case 7:
+            gNeutralConfig->LoadItemStats(item, random, count, sum, sketch);
+            break;
+        default:
+            continue;
+        }
+
+        loaded++;
+    } while (result->NextRow());
+
+    LOG_INFO("server.loading", "AHBot: loaded {} market prices", loaded);
+}
+
+void AHBot_WorldScript::SaveMarketStats(bool all)
+{
+    uint32 batch = gAllianceConfig->MarketFlushBatch;
+
+    gAllianceConfig->SaveItemStats(batch, all);
+    gHordeConfig->SaveItemStats   (batch, all);
+    gNeutralConfig->SaveItemStats (batch, all);
+}
+
+void AHBot_WorldScript::SaveCheckpoint()
+{
+    if (!gAllianceConfig->Checkpoint || gBots.empty())
+    {
+        return;
+    }
+
+    for (AHBConfig* config : { gAllianceConfig, gHordeConfig, gNeutralConfig })
+    {
+        std::map<uint32, uint32> lastRuns;
+
+        for (AuctionHouseBot* bot : gBots)
+        {
+            lastRuns[bot->GetAHBplayerGUID()] = uint32(bot->GetLastRun(config));
+        }
+
+        config->SaveCheckpoint(lastRuns);
+    }
 }
@@ -7,6 +7,8 @@
 
 #include "ScriptMgr.h"
 
+#include "AuctionHouseBotExporter.h"
+
 // =============================================================================
 // Interaction with the world core mechanisms
 // =============================================================================
@@ -14,14 +16,27 @@
 class AHBot_WorldScript : public WorldScript
 {
 private:
+    uint32      _marketFlushTimer;
+    uint32      _metricsTimer;
+    uint32      _recordTimer;
+    uint32      _columnarTimer;
+
+    AHBExporter _exporter;
+
     void DeleteBots();
     void PopulateBots();
 
+    void LoadMarketStats();
+    void SaveMarketStats(bool all);
+    void SaveCheckpoint ();
+
 public:
     AHBot_WorldScript();
 
     void OnBeforeConfigLoad(bool reload) override;
     void OnStartup() override;
+    void OnUpdate(uint32 diff) override;
+    void OnShutdown() override;
 };
 
 #endif /* AUCTION_HOUSE_BOT_WORLD_SCRIPT_H */
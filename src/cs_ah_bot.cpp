@@ -25,7 +25,14 @@ EndScriptData */
 #include "ScriptMgr.h"
 #include "Chat.h"
 #include "AuctionHouseBot.h"
+#include "AuctionHouseBotColumnar.h"
+#include "AuctionHouseBotJob.h"
+#include "AuctionHouseBotLoad.h"
+#include "AuctionHouseBotMemory.h"
+#include "AuctionHouseBotSweeper.h"
+#include "AuctionHouseBotSynthetic.h"
 #include "Config.h"
+#include "StringFormat.h"
 
 #if AC_COMPILER == AC_COMPILER_GNU
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -80,6 +87,23 @@ private:
         return static_cast<ItemQualities>(-1); // Invalid
     }
 
+    static AHBConfig* getConfig(uint32 ahMapID)
+    {
+        //
+        // Configuration shared by all the bots for the given auction house
+        //
+
+        switch (ahMapID)
+        {
+        case 2:
+            return gAllianceConfig;
+        case 6:
+            return gHordeConfig;
+        default:
+            return gNeutralConfig;
+        }
+    }
+
 public:
     ah_bot_commandscript() : CommandScript("ah_bot_commandscript")
     {
@@ -125,9 +149,9 @@ public:
                 return false;
             }
 
-            for (AuctionHouseBot* bot: gBots)
+            for (AHBConfig* config : { gAllianceConfig, gHordeConfig, gNeutralConfig })
             {
-                bot->Commands(AHBotCommand::buyer, 0, 0, param1);
+                config->Commands(AHBotCommand::buyer, 0, param1);
             }
 
             return true;
@@ -142,9 +166,9 @@ public:
                 return false;
             }
 
-            for (AuctionHouseBot* bot: gBots)
+            for (AHBConfig* config : { gAllianceConfig, gHordeConfig, gNeutralConfig })
             {
-                bot->Commands(AHBotCommand::seller, 0, 0, param1);
+                config->Commands(AHBotCommand::seller, 0, param1);
             }
 
             return true;
@@ -159,13 +183,250 @@ public:
                 return false;
             }
 
+            for (AHBConfig* config : { gAllianceConfig, gHordeConfig, gNeutralConfig })
+            {
+                config->Commands(AHBotCommand::useMarketPrice, 0, param1);
+            }
+
+            return true;
+        }
+        else if (strncmp(opt, "stats", l) == 0)
+        {
+            std::vector<std::string> lines;
+
+            //
+            // Per auction house, all the bots together
+            //
+
+            for (AHBConfig* config : { gAllianceConfig, gHordeConfig, gNeutralConfig })
+            {
+                lines.push_back(Acore::StringFormat("Auction house {}:", config->GetAHID()));
+                config->Stats.Report(lines);
+            }
+
+            //
+            // Per bot, all the auction houses together
+            //
+
             for (AuctionHouseBot* bot : gBots)
             {
-                bot->Commands(AHBotCommand::useMarketPrice, 0, 0, param1);
+                lines.push_back(Acore::StringFormat("Bot {}:", bot->GetAHBplayerGUID()));
+                bot->GetStats().Report(lines);
+            }
+
+            //
+            // Database calls of the whole module, by call site
+            //
+
+            lines.push_back("Database calls (last and worst cycle as sync/async/append/commit):");
+            gDbStats.Report(lines);
+
+            for (std::string const& line : lines)
+            {
+                handler->SendSysMessage(line);
+            }
+
+            return true;
+        }
+        else if (strncmp(opt, "trace", l) == 0)
+        {
+            char*  param1 = strtok(NULL, " ");
+            uint32 max    = param1 ? uint32(strtoul(param1, NULL, 0)) : 50;
+
+            std::vector<std::string> lines;
+
+            gTracer.Dump(lines, max);
+
+            handler->SendSysMessage(Acore::StringFormat("AHBot: {} trace records, showing the last {}", gTracer.GetTotal(), lines.size()));
+
+            for (std::string const& line : lines)
+            {
+                handler->SendSysMessage(line);
+            }
+
+            return true;
+        }
+        else if (strcmp(opt, "hooks") == 0)
+        {
+            //
+            // Full name only, "h" stays the help
+            //
+
+            char* param1 = strtok(NULL, " ");
+
+            if (param1)
+            {
+                if (strcmp(param1, "on") == 0)
+                {
+                    gHookStats.SetTimings(true);
+                }
+                else if (strcmp(param1, "off") == 0)
+                {
+                    gHookStats.SetTimings(false);
+                }
+                else if (strcmp(param1, "reset") == 0)
+                {
+                    gHookStats.Reset();
+                }
+                else
+                {
+                    handler->PSendSysMessage("Syntax is: ahbotoptions hooks [on|off|reset]");
+                    return false;
+                }
+            }
+
+            std::vector<std::string> lines;
+
+            gHookStats.Report(lines);
+
+            handler->SendSysMessage(Acore::StringFormat("AHBot: hooks timings {}", gHookStats.HasTimings() ? "enabled" : "disabled"));
+
+            for (std::string const& line : lines)
+            {
+                handler->SendSysMessage(line);
+            }
+
+            return true;
+        }
+        else if (strncmp(opt, "columnar", l) == 0)
+        {
+            if (!gColumnar.Running())
+            {
+                handler->PSendSysMessage("AHBot: the columnar export is disabled, set AuctionHouseBot.ColumnarDirectory");
+                return false;
+            }
+
+            for (AHBConfig* config : { gAllianceConfig, gHordeConfig, gNeutralConfig })
+            {
+                gColumnar.Snapshot(config);
+            }
+
+            handler->PSendSysMessage("AHBot: columnar snapshots taken, the files are being written");
+
+            return true;
+        }
+        else if (strcmp(opt, "memory") == 0)
+        {
+            //
+            // Full name only, "m" stays minitems and "max" maxitems
+            //
+
+            std::vector<std::string> lines;
+            uint64                   total = 0;
+
+            //
+            // Per auction house
+            //
+
+            for (AHBConfig* config : { gAllianceConfig, gHordeConfig, gNeutralConfig })
+            {
+                std::vector<std::string> houseLines;
+                uint64                   house = config->ReportMemory(houseLines);
+
+                lines.push_back(Acore::StringFormat("Auction house {}: {} bytes", config->GetAHID(), house));
+                lines.insert(lines.end(), houseLines.begin(), houseLines.end());
+
+                total += house;
+            }
+
+            //
+            // Per bot, and shared by all of them
+            //
+
+            uint64 bots    = gBots.size() * sizeof(AuctionHouseBot);
+            uint64 botsIds = AHBMemory(gBotsId) + AHBMemory(gBots);
+            uint64 shared  = sizeof(gTracer) + gRecorder.GetMemory() + sizeof(gDbStats) + sizeof(gHookStats) + gLoadGenerator.GetMemory();
+
+            lines.push_back(Acore::StringFormat("Bots: {} x {} bytes, ids {} bytes", gBots.size(), sizeof(AuctionHouseBot), botsIds));
+            lines.push_back(Acore::StringFormat("Shared: {} bytes (trace {}, record buffer {}, database and hooks counters {}, load test {})",
+                shared, sizeof(gTracer), gRecorder.GetMemory(), sizeof(gDbStats) + sizeof(gHookStats), gLoadGenerator.GetMemory()));
+
+            total += bots + botsIds + shared;
+
+            lines.push_back(Acore::StringFormat("Total: {} bytes ({} kB), estimated", total, total / 1024));
+
+            for (std::string const& line : lines)
+            {
+                handler->SendSysMessage(line);
             }
 
             return true;
         }
+        else if (strncmp(opt, "sweep", l) == 0)
+        {
+            std::vector<std::string> lines;
+
+            gSweeper.Report(lines);
+
+            for (std::string const& line : lines)
+            {
+                handler->SendSysMessage(line);
+            }
+
+            return true;
+        }
+        else if (strncmp(opt, "load", l) == 0)
+        {
+            char* param1 = strtok(NULL, " ");
+
+            if (!param1)
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions load $ahMapID (2, 6 or 7) $auctions $bids $buyouts $seconds, or load status|stop");
+                return false;
+            }
+
+            //
+            // The load test runs from the world updates, these only look at it or end it early
+            //
+
+            if (strcmp(param1, "status") == 0 || strcmp(param1, "stop") == 0)
+            {
+                std::vector<std::string> lines;
+
+                gLoadGenerator.Report(lines);
+
+                for (std::string const& line : lines)
+                {
+                    handler->SendSysMessage(line);
+                }
+
+                if (strcmp(param1, "stop") == 0)
+                {
+                    gLoadGenerator.Stop();
+                }
+
+                return true;
+            }
+
+            char* param2 = strtok(NULL, " ");
+            char* param3 = strtok(NULL, " ");
+            char* param4 = strtok(NULL, " ");
+            char* param5 = strtok(NULL, " ");
+
+            ahMapID = uint32(strtoul(param1, NULL, 0));
+
+            if ((ahMapID != 2 && ahMapID != 6 && ahMapID != 7) || !param2 || !param3 || !param4 || !param5)
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions load $ahMapID (2, 6 or 7) $auctions $bids $buyouts $seconds, or load status|stop");
+                return false;
+            }
+
+            std::string error;
+
+            if (!gLoadGenerator.Start(getConfig(ahMapID),
+                uint32(strtoul(param2, NULL, 0)),
+                uint32(strtoul(param3, NULL, 0)),
+                uint32(strtoul(param4, NULL, 0)),
+                uint32(strtoul(param5, NULL, 0)), error))
+            {
+                handler->SendSysMessage(Acore::StringFormat("AHBot: could not start the load test, {}", error));
+                return false;
+            }
+
+            handler->SendSysMessage("AHBot: load test started, see load status or the server log for the report");
+
+            return true;
+        }
 
         //
         // Retrieve the auction house type
@@ -209,7 +470,17 @@ public:
             handler->PSendSysMessage("buyer - enable/disable buyer");
             handler->PSendSysMessage("seller - enable/disabler seller");
             handler->PSendSysMessage("usemarketprice - enable/disabler selling at market price");
-            handler->PSendSysMessage("ahexpire - remove all bot auctions");
+            handler->PSendSysMessage("stats - show the timings, counters and database calls of the bots");
+            handler->PSendSysMessage("trace - show the most recent trace records, 50 by default");
+            handler->PSendSysMessage("hooks - show the calls and timings of the auction and mail hooks, optionally on/off/reset");
+            handler->PSendSysMessage("columnar - write the columnar files of the auctions and market statistics now");
+            handler->PSendSysMessage("memory - show the estimated memory of the lists, bins, statistics and bots");
+            handler->PSendSysMessage("load - inject synthetic auctions, bids and buyouts per second in a house, or show/stop the running test");
+            handler->PSendSysMessage("sweep - show the progress of the sweeper of the orphaned item rows of the bots");
+            handler->PSendSysMessage("ahexpire - remove all bot auctions, optionally spread over a window");
+            handler->PSendSysMessage("bench - time the selling and buying decisions on generated templates and auctions, in the background");
+            handler->PSendSysMessage("replay - replay a recorded event stream on a copy of the configuration, in the background, then check that the market learns the same prices twice with the seed");
+            handler->PSendSysMessage("scaling - time the startup stages (lists, bins, auction scan) and their peak memory against 10k to 1M generated item templates, in the background");
             handler->PSendSysMessage("minitems - set min auctions");
             handler->PSendSysMessage("maxitems - set max auctions");
             handler->PSendSysMessage("percentages - set selling percentages");
@@ -226,46 +497,204 @@ public:
         }
         else if (strncmp(opt, "ahexpire", l) == 0)
         {
+            char* param1 = strtok(NULL, " ");
+
+            if (!ahMapIdStr)
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions ahexpire $ahMapID (2, 6 or 7) [$window (in seconds)]");
+                return false;
+            }
+
+            getConfig(ahMapID)->Commands(AHBotCommand::ahexpire, 0, param1);
+        }
+        else if (strncmp(opt, "bench", l) == 0)
+        {
+            char*  param1 = strtok(NULL, " ");
+            uint32 seed   = param1 ? uint32(strtoul(param1, NULL, 0)) : 0;
+
             if (!ahMapIdStr)
             {
-                handler->PSendSysMessage("Syntax is: ahbotoptions ahexpire $ahMapID (2, 6 or 7)");
+                handler->PSendSysMessage("Syntax is: ahbotoptions bench $ahMapID (2, 6 or 7) [$seed]");
                 return false;
             }
 
-            for (AuctionHouseBot* bot: gBots)
+            //
+            // The configuration is copied here, the benchmark thread only ever sees the copy
+            //
+
+            std::shared_ptr<AHBConfig> scratch = std::make_shared<AHBConfig>(ahMapID, getConfig(ahMapID));
+
+            scratch->MarketMergeHouses = false;
+            scratch->PopulationScaling = false;
+
+            uint32 botId = gBotsId.empty() ? 0 : *gBotsId.begin();
+
+            if (!gJob.Start("bench", [scratch, botId, seed](std::vector<std::string>& lines)
+                {
+                    AHBDecisionBenchmark(scratch.get(), AHBSyntheticProfile(), botId, seed, lines);
+                }))
             {
-                bot->Commands(AHBotCommand::ahexpire, ahMapID, 0, NULL);
+                handler->SendSysMessage(Acore::StringFormat("AHBot: {} is still running", gJob.GetName()));
+                return false;
             }
+
+            handler->SendSysMessage("AHBot: benchmark started, see the server log for the report");
         }
-        else if (strncmp(opt, "minitems", l) == 0)
+        else if (strncmp(opt, "replay", l) == 0)
         {
             char* param1 = strtok(NULL, " ");
+            char* param2 = strtok(NULL, " ");
 
             if (!ahMapIdStr || !param1)
             {
-                handler->PSendSysMessage("Syntax is: ahbotoptions minitems $ahMapID (2, 6 or 7) $minItems");
+                handler->PSendSysMessage("Syntax is: ahbotoptions replay $ahMapID (2, 6 or 7) $file [$seed]");
                 return false;
             }
 
-            for (AuctionHouseBot* bot : gBots)
+            //
+            // Only the files next to the record file are read, given by name
+            //
+
+            std::string const& recordFile = gAllianceConfig->RecordFile;
+            std::string        file       = param1;
+
+            if (recordFile.empty() || file.find_first_of("/\\") != std::string::npos || file.find("..") != std::string::npos)
             {
-                bot->Commands(AHBotCommand::minitems, ahMapID, 0, param1);
+                handler->PSendSysMessage("AHBot: replay reads the files of the directory of AuctionHouseBot.RecordFile, given by name");
+                return false;
             }
+
+            std::string::size_type slash = recordFile.find_last_of("/\\");
+            std::string            path  = slash == std::string::npos ? file : recordFile.substr(0, slash + 1) + file;
+
+            //
+            // Replay on a scratch copy of the configuration, starting with no market knowledge;
+            // the live auction house is never consulted for duplicates
+            //
+
+            std::shared_ptr<AHBConfig> scratch = std::make_shared<AHBConfig>(ahMapID, getConfig(ahMapID));
+
+            scratch->DuplicatesCount   = 0;
+            scratch->MarketMergeHouses = false;
+            scratch->PopulationScaling = false;
+            scratch->CalculatePercents();
+
+            uint32 botId = gBotsId.empty() ? 0 : *gBotsId.begin();
+            uint32 seed  = param2 ? uint32(strtoul(param2, NULL, 0)) : 0;
+
+            if (!gJob.Start("replay", [scratch, path, botId, seed](std::vector<std::string>& lines)
+                {
+                    std::vector<AHBRecord> records;
+
+                    if (!AHBRecorder::Load(path, records))
+                    {
+                        lines.push_back(Acore::StringFormat("could not read the records from {}", path));
+                        return;
+                    }
+
+                    AuctionHouseBot simulator(0, botId);
+
+                    simulator.Seed(seed);
+                    simulator.Replay(scratch.get(), records, lines);
+
+                    if (!gJob.Cancelled())
+                    {
+                        AHBMarketReplayCheck(scratch.get(), seed, lines);
+                    }
+                }))
+            {
+                handler->SendSysMessage(Acore::StringFormat("AHBot: {} is still running", gJob.GetName()));
+                return false;
+            }
+
+            handler->SendSysMessage("AHBot: replay started, see the server log for the report");
         }
-        else if (strncmp(opt, "maxitems", l) == 0)
+        else if (strncmp(opt, "scaling", l) == 0)
+        {
+            char* param1 = strtok(NULL, " ");
+            char* param2 = strtok(NULL, " ");
+            char* param3 = strtok(NULL, " ");
+            char* param4 = strtok(NULL, " ");
+            char* param5 = strtok(NULL, " ");
+
+            if (!ahMapIdStr)
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions scaling $ahMapID (2, 6 or 7) [$maxTemplates] [$tradeGoods%] [$vendor%] [$loot%] [$seed]");
+                return false;
+            }
+
+            //
+            // The generated store is held in memory during the run: 1M templates take several hundred megabytes
+            //
+
+            AHBSyntheticProfile profile;
+
+            uint32 maxTemplates = param1 ? uint32(strtoul(param1, NULL, 0)) : AHB_SCALING_MAX_TEMPLATES;
+            uint32 seed         = param5 ? uint32(strtoul(param5, NULL, 0)) : 0;
+
+            if (maxTemplates < AHB_SCALING_MIN_TEMPLATES || maxTemplates > AHB_SCALING_MAX_TEMPLATES)
+            {
+                handler->SendSysMessage(Acore::StringFormat("AHBot: the maximum of templates must be between {} and {}", AHB_SCALING_MIN_TEMPLATES, AHB_SCALING_MAX_TEMPLATES));
+                return false;
+            }
+
+            if (param2)
+            {
+                profile.TradeGoods = uint32(strtoul(param2, NULL, 0));
+            }
+
+            if (param3)
+            {
+                profile.Vendor = uint32(strtoul(param3, NULL, 0));
+            }
+
+            if (param4)
+            {
+                profile.Loot = uint32(strtoul(param4, NULL, 0));
+            }
+
+            //
+            // The configuration is copied here, the benchmark thread only ever sees the copy
+            //
+
+            std::shared_ptr<AHBConfig> scratch = std::make_shared<AHBConfig>(ahMapID, getConfig(ahMapID));
+
+            scratch->PopulationScaling = false;
+
+            if (!gJob.Start("scaling", [scratch, profile, maxTemplates, seed](std::vector<std::string>& lines)
+                {
+                    AHBScalingBenchmark(scratch.get(), profile, maxTemplates, seed, lines);
+                }))
+            {
+                handler->SendSysMessage(Acore::StringFormat("AHBot: {} is still running", gJob.GetName()));
+                return false;
+            }
+
+            handler->SendSysMessage("AHBot: scaling benchmark started, see the server log for the report");
+        }
+        else if (strncmp(opt, "minitems", l) == 0)
         {
             char* param1 = strtok(NULL, " ");
 
             if (!ahMapIdStr || !param1)
             {
-                handler->PSendSysMessage("Syntax is: ahbotoptions maxitems $ahMapID (2, 6 or 7) $maxItems");
+                handler->PSendSysMessage("Syntax is: ahbotoptions minitems $ahMapID (2, 6 or 7) $minItems");
                 return false;
             }
 
-            for (AuctionHouseBot* bot: gBots)
+            getConfig(ahMapID)->Commands(AHBotCommand::minitems, 0, param1);
+        }
+        else if (strncmp(opt, "maxitems", l) == 0)
+        {
+            char* param1 = strtok(NULL, " ");
+
+            if (!ahMapIdStr || !param1)
             {
-                bot->Commands(AHBotCommand::maxitems, ahMapID, 0, param1);
+                handler->PSendSysMessage("Syntax is: ahbotoptions maxitems $ahMapID (2, 6 or 7) $maxItems");
+                return false;
             }
+
+            getConfig(ahMapID)->Commands(AHBotCommand::maxitems, 0, param1);
         }
         else if (strncmp(opt, "percentages", l) == 0)
         {
@@ -348,10 +777,7 @@ public:
             strcat(param, " ");
             strcat(param, param14);
 
-            for (AuctionHouseBot* bot: gBots)
-            {
-                bot->Commands(AHBotCommand::percentages, ahMapID, 0, param);
-            }
+            getConfig(ahMapID)->Commands(AHBotCommand::percentages, 0, param);
         }
         else if (strncmp(opt, "minprice", l) == 0)
         {
@@ -368,10 +794,7 @@ public:
 
             if (quality != static_cast<ItemQualities>(-1))
             {
-                for (AuctionHouseBot* bot: gBots)
-                {
-                    bot->Commands(AHBotCommand::minprice, ahMapID, quality, param2);
-                }
+                getConfig(ahMapID)->Commands(AHBotCommand::minprice, quality, param2);
             }
             else
             {
@@ -394,10 +817,7 @@ public:
 
             if (quality != static_cast<ItemQualities>(-1))
             {
-                for (AuctionHouseBot* bot: gBots)
-                {
-                    bot->Commands(AHBotCommand::maxprice, ahMapID, quality, param2);
-                }
+                getConfig(ahMapID)->Commands(AHBotCommand::maxprice, quality, param2);
             }
             else
             {
@@ -428,10 +848,7 @@ public:
 
             if (quality != static_cast<ItemQualities>(-1))
             {
-                for (AuctionHouseBot* bot: gBots)
-                {
-                    bot->Commands(AHBotCommand::minbidprice, ahMapID, quality, param2);
-                }
+                getConfig(ahMapID)->Commands(AHBotCommand::minbidprice, quality, param2);
             }
             else
             {
@@ -462,10 +879,7 @@ public:
 
             if (quality != static_cast<ItemQualities>(-1))
             {
-                for (AuctionHouseBot* bot: gBots)
-                {
-                    bot->Commands(AHBotCommand::maxbidprice, ahMapID, quality, param2);
-                }
+                getConfig(ahMapID)->Commands(AHBotCommand::maxbidprice, quality, param2);
             }
             else
             {
@@ -495,10 +909,7 @@ public:
 
             if (quality != static_cast<ItemQualities>(-1))
             {
-                for (AuctionHouseBot* bot: gBots)
-                {
-                    bot->Commands(AHBotCommand::maxstack, ahMapID, quality, param2);
-                }
+                getConfig(ahMapID)->Commands(AHBotCommand::maxstack, quality, param2);
             }
             else
             {
@@ -521,10 +932,7 @@ public:
 
             if (quality != static_cast<ItemQualities>(-1))
             {
-                for (AuctionHouseBot* bot: gBots)
-                {
-                    bot->Commands(AHBotCommand::buyerprice, ahMapID, quality, param2);
-                }
+                getConfig(ahMapID)->Commands(AHBotCommand::buyerprice, quality, param2);
             }
             else
             {
@@ -542,10 +950,7 @@ public:
                 return false;
             }
 
-            for (AuctionHouseBot* bot: gBots)
-            {
-                bot->Commands(AHBotCommand::bidinterval, ahMapID, 0, param1);
-            }
+            getConfig(ahMapID)->Commands(AHBotCommand::bidinterval, 0, param1);
         }
         else if (strncmp(opt, "bidsperinterval", l) == 0)
         {
@@ -557,10 +962,7 @@ public:
                 return false;
             }
 
-            for (AuctionHouseBot* bot: gBots)
-            {
-                bot->Commands(AHBotCommand::bidsperinterval, ahMapID, 0, param1);
-            }
+            getConfig(ahMapID)->Commands(AHBotCommand::bidsperinterval, 0, param1);
         }
         else
         {